@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+// cpplargeringbuffer - segment size benchmark
+//-----------------------------------------------------------------------------
+
+#include <cpplargeringbuffer/cpplargeringbuffer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    template <typename function_type>
+    double measure(size_t items, function_type function, std::uint64_t& checksum)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        checksum += function();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0 ? static_cast<double>(items) / seconds / 1e6 : 0.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // usage: benchmark_geometry [bytes_stored]
+    // Prints M items/s of std::uint64_t items per segment size in bytes for:
+    // fill:      pushing into an empty ring buffer, allocates all segments
+    // overwrite: pushing into a full ring buffer
+    // scan:      for_each over all items
+    // random:    operator[] at random indices
+    // churn:     pushing and popping half of the capacity, frees and allocates segments
+    const size_t bytes = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1024 * 1024 * 1024;
+    const size_t item_count = bytes / sizeof(std::uint64_t);
+    std::uint64_t checksum = 0;
+
+    std::cout << "segment bytes | fill | overwrite | scan | random | churn" << std::endl;
+    std::cout << "---: | ---: | ---: | ---: | ---: | ---:" << std::endl;
+    for (size_t segment_bytes = 4 * 1024; segment_bytes <= 4 * 1024 * 1024; segment_bytes *= 4)
+    {
+        const size_t segment_size = segment_bytes / sizeof(std::uint64_t);
+        cpplargeringbuffer::large_ring_buffer<std::uint64_t> ringbuffer(item_count / segment_size, segment_size);
+        const size_t max_size = ringbuffer.get_max_size();
+
+        const double fill = measure(max_size, [&ringbuffer, max_size]()
+        {
+            for (size_t i = 0; i < max_size; ++i)
+            {
+                ringbuffer.push_back(i);
+            }
+            return static_cast<std::uint64_t>(ringbuffer.size());
+        }, checksum);
+
+        const double overwrite = measure(max_size, [&ringbuffer, max_size]()
+        {
+            for (size_t i = 0; i < max_size; ++i)
+            {
+                ringbuffer.push_back(i);
+            }
+            return static_cast<std::uint64_t>(ringbuffer.size());
+        }, checksum);
+
+        const double scan = measure(max_size, [&ringbuffer]()
+        {
+            std::uint64_t sum = 0;
+            ringbuffer.for_each([&sum](std::uint64_t item)
+            {
+                sum += item;
+            });
+            return sum;
+        }, checksum);
+
+        const size_t lookups = 10000000;
+        std::vector<size_t> indices(lookups);
+        std::mt19937_64 generator(42);
+        std::uniform_int_distribution<size_t> distribution(0, max_size - 1);
+        for (size_t& index : indices)
+        {
+            index = distribution(generator);
+        }
+        const double random = measure(lookups, [&ringbuffer, &indices]()
+        {
+            std::uint64_t sum = 0;
+            for (size_t index : indices)
+            {
+                sum += ringbuffer[index];
+            }
+            return sum;
+        }, checksum);
+
+        const double churn = measure(max_size * 2, [&ringbuffer, max_size]()
+        {
+            const size_t half = max_size / 2;
+            for (size_t round = 0; round < 2; ++round)
+            {
+                for (size_t i = 0; i < half; ++i)
+                {
+                    ringbuffer.pop_front();
+                }
+                for (size_t i = 0; i < half; ++i)
+                {
+                    ringbuffer.push_back(i);
+                }
+            }
+            return static_cast<std::uint64_t>(ringbuffer.size());
+        }, checksum);
+
+        std::cout << std::fixed << std::setprecision(0) << segment_bytes / 1024 << " KiB | " << fill << " | " << overwrite << " | " << scan << " | " << random << " | " << churn << std::endl;
+    }
+    std::cerr << "checksum " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------
+// cpplargeringbuffer - sequential scan benchmark
+//-----------------------------------------------------------------------------
+
+#include <cpplargeringbuffer/cpplargeringbuffer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    struct large_item
+    {
+        std::uint64_t key;
+        std::uint64_t payload[31];
+    };
+
+    template <typename function_type>
+    void measure(const char* name, size_t items, function_type function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const std::uint64_t result = function();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << (seconds > 0 ? static_cast<double>(items) / seconds / 1e6 : 0.0) << " M items/s (" << result << ")" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // usage: benchmark_scan [number_of_items] [segment_size]
+    const size_t item_count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000000;
+    const size_t segment_size = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 4096;
+
+    {
+        cpplargeringbuffer::large_ring_buffer<std::uint64_t> ringbuffer((item_count + segment_size - 1) / segment_size, segment_size);
+        for (size_t i = 0; i < ringbuffer.get_max_size() + segment_size / 2; ++i)
+        {
+            ringbuffer.push_back(i);
+        }
+        const size_t items = ringbuffer.size();
+        std::cout << "std::uint64_t items: " << items << ", segment size: " << segment_size << std::endl;
+
+        measure("operator[]", items, [&ringbuffer, items]()
+        {
+            std::uint64_t sum = 0;
+            for (size_t i = 0; i < items; ++i)
+            {
+                sum += ringbuffer[i];
+            }
+            return sum;
+        });
+        measure("iterator", items, [&ringbuffer]()
+        {
+            std::uint64_t sum = 0;
+            for (std::uint64_t item : ringbuffer)
+            {
+                sum += item;
+            }
+            return sum;
+        });
+        measure("for_each", items, [&ringbuffer]()
+        {
+            std::uint64_t sum = 0;
+            ringbuffer.for_each([&sum](std::uint64_t item)
+            {
+                sum += item;
+            });
+            return sum;
+        });
+    }
+
+    {
+        // same memory footprint with 256 byte items
+        const size_t large_count = item_count / (sizeof(large_item) / sizeof(std::uint64_t));
+        const size_t large_segment_size = segment_size / (sizeof(large_item) / sizeof(std::uint64_t)) + 1;
+        cpplargeringbuffer::large_ring_buffer<large_item> ringbuffer((large_count + large_segment_size - 1) / large_segment_size, large_segment_size);
+        for (size_t i = 0; i < ringbuffer.get_max_size(); ++i)
+        {
+            ringbuffer.extend_back().key = i;
+        }
+        const size_t items = ringbuffer.size();
+        std::cout << "large_item items: " << items << ", segment size: " << large_segment_size << std::endl;
+
+        measure("operator[] large", items, [&ringbuffer, items]()
+        {
+            std::uint64_t sum = 0;
+            for (size_t i = 0; i < items; ++i)
+            {
+                sum += ringbuffer[i].key;
+            }
+            return sum;
+        });
+        for (size_t distance = 0; distance <= 8; distance += 4)
+        {
+            ringbuffer.set_prefetch_distance(distance);
+            std::cout << "prefetch distance " << distance << std::endl;
+            measure("for_each large", items, [&ringbuffer]()
+            {
+                std::uint64_t sum = 0;
+                ringbuffer.for_each([&sum](const large_item& item)
+                {
+                    sum += item.key;
+                });
+                return sum;
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+//-----------------------------------------------------------------------------
+// cpplargeringbuffer - snapshot benchmark
+//-----------------------------------------------------------------------------
+
+#include <cpplargeringbuffer/cpplargeringbuffer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    double to_gigabytes_per_second(size_t bytes, std::chrono::steady_clock::duration duration)
+    {
+        const double seconds = std::chrono::duration<double>(duration).count();
+        return seconds > 0 ? static_cast<double>(bytes) / seconds / 1e9 : 0.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // usage: benchmark_snapshot [number_of_segments] [segment_size] [file]
+    const size_t number_of_segments = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 256;
+    const size_t segment_size = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 65536;
+    const char* file_name = argc > 3 ? argv[3] : "benchmark_snapshot.bin";
+
+    typedef std::uint64_t value_type;
+    cpplargeringbuffer::large_ring_buffer<value_type> ringbuffer(number_of_segments, segment_size);
+    for (size_t i = 0; i < ringbuffer.get_max_size() + segment_size / 2; ++i)
+    {
+        ringbuffer.push_back(i);
+    }
+    const size_t bytes = ringbuffer.size() * sizeof(value_type);
+    std::cout << "items: " << ringbuffer.size() << ", bytes: " << bytes << std::endl;
+
+    {
+        // baseline: per element serialization using operator[]
+        std::ofstream stream(file_name, std::ios::binary);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ringbuffer.size(); ++i)
+        {
+            stream.write(reinterpret_cast<const char*>(&ringbuffer[i]), sizeof(value_type));
+        }
+        stream.flush();
+        const auto duration = std::chrono::steady_clock::now() - start;
+        std::cout << "per element write: " << to_gigabytes_per_second(bytes, duration) << " GB/s" << std::endl;
+    }
+
+    {
+        std::ofstream stream(file_name, std::ios::binary);
+        const auto start = std::chrono::steady_clock::now();
+        ringbuffer.save(stream);
+        stream.flush();
+        const auto duration = std::chrono::steady_clock::now() - start;
+        std::cout << "save: " << to_gigabytes_per_second(bytes, duration) << " GB/s" << std::endl;
+    }
+
+    {
+        cpplargeringbuffer::large_ring_buffer<value_type> restored;
+        std::ifstream stream(file_name, std::ios::binary);
+        const auto start = std::chrono::steady_clock::now();
+        restored.load(stream);
+        const auto duration = std::chrono::steady_clock::now() - start;
+        std::cout << "load: " << to_gigabytes_per_second(bytes, duration) << " GB/s" << std::endl;
+        if (restored.size() != ringbuffer.size() || restored.front() != ringbuffer.front() || restored.back() != ringbuffer.back())
+        {
+            std::cerr << "restored ring buffer does not match" << std::endl;
+            return 1;
+        }
+    }
+
+    std::remove(file_name);
+    return 0;
+}
@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+// cpplargeringbuffer - startup benchmark
+//-----------------------------------------------------------------------------
+
+#include <cpplargeringbuffer/cpplargeringbuffer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    struct constructed_item
+    {
+        std::uint64_t key = 1;
+        std::uint64_t payload[7] = {};
+    };
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // measures reserve_all and a first pass writing all items, the first write to a page causes the page fault
+    template <typename ring_buffer_type, typename item_type>
+    void measure(const char* name, size_t item_count, size_t segment_size, size_t threads, const item_type& item)
+    {
+        ring_buffer_type ringbuffer(item_count / segment_size, segment_size);
+        auto start = std::chrono::steady_clock::now();
+        ringbuffer.reserve_all(threads);
+        const double reserve = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ringbuffer.get_max_size(); ++i)
+        {
+            ringbuffer.push_back(item);
+        }
+        const double fill = seconds_since(start);
+        std::cout << name << ", " << threads << " thread(s): reserve_all " << reserve << " s, first fill " << fill << " s, total " << reserve + fill << " s" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // usage: benchmark_startup [bytes] [threads]
+    const size_t bytes = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1024 * 1024 * 1024;
+    const size_t hardware_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const size_t threads = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : hardware_threads;
+    const size_t segment_bytes = 1024 * 1024;
+    std::cout << "bytes: " << bytes << ", segment bytes: " << segment_bytes << std::endl;
+
+    typedef cpplargeringbuffer::large_ring_buffer<std::uint64_t> default_ring_buffer;
+    typedef cpplargeringbuffer::large_ring_buffer<std::uint64_t, cpplargeringbuffer::noop_clear_handler<std::uint64_t>, cpplargeringbuffer::zero_page_allocator<std::uint64_t> > zero_page_ring_buffer;
+    const size_t count = bytes / sizeof(std::uint64_t);
+    const size_t segment_size = segment_bytes / sizeof(std::uint64_t);
+    measure<default_ring_buffer>("std::uint64_t std::allocator", count, segment_size, 1, std::uint64_t(1));
+    measure<default_ring_buffer>("std::uint64_t std::allocator", count, segment_size, threads, std::uint64_t(1));
+    measure<zero_page_ring_buffer>("std::uint64_t zero_page_allocator", count, segment_size, 1, std::uint64_t(1));
+
+    typedef cpplargeringbuffer::large_ring_buffer<constructed_item> constructed_ring_buffer;
+    const size_t constructed_count = bytes / sizeof(constructed_item);
+    const size_t constructed_segment_size = segment_bytes / sizeof(constructed_item);
+    measure<constructed_ring_buffer>("constructed_item std::allocator", constructed_count, constructed_segment_size, 1, constructed_item());
+    measure<constructed_ring_buffer>("constructed_item std::allocator", constructed_count, constructed_segment_size, threads, constructed_item());
+    return 0;
+}
@@ -0,0 +1,345 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains a thread safe large ring buffer that C++20 coroutines can await items from
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#if !defined(__cpp_impl_coroutine)
+#error "async_large_ring_buffer.hpp requires C++20 coroutine support."
+#endif
+#include <algorithm>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A thread safe wrapper of a large ring buffer that lets coroutines wait for items.
+
+        co_await next() suspends the coroutine until an item is available and removes it,
+        co_await next_batch(n) removes up to n items at once. Items are handed to waiting
+        coroutines in the order they started waiting. The producer resumes a waiting coroutine
+        with the executor, e.g. by posting the handle to an event loop, after it released the lock.
+        The default executor resumes the coroutine in the producer thread.
+
+        Coroutines still waiting when the ring buffer is destroyed are not resumed.
+        A coroutine can be destroyed while it waits, e.g. if its task is cancelled, its awaiter
+        removes itself from the waiting coroutines. It must not be destroyed concurrently with
+        a producer that hands items to it, i.e. destroy it on the thread that runs the producer
+        or the executor.
+    */
+    template <typename value_type, typename ring_buffer_type = large_ring_buffer<value_type> >
+    class async_large_ring_buffer
+    {
+        struct waiter
+        {
+            std::coroutine_handle<> handle;
+            size_t max_count = 0;
+            std::vector<value_type> items;
+        };
+
+    public:
+        /**
+            \brief Function that resumes a coroutine whose items are available.
+        */
+        typedef std::function<void(std::coroutine_handle<> handle)> executor_type;
+
+        /**
+            \brief Awaitable returned by next(), co_await delivers the item.
+        */
+        class item_awaiter
+        {
+        public:
+            /**
+                \brief Constructs an awaiter.
+                \param[in] ring_buffer  The ring buffer to take the item from.
+            */
+            explicit item_awaiter(async_large_ring_buffer& ring_buffer)
+                : m_ring_buffer(ring_buffer)
+            {
+                m_waiter.max_count = 1;
+            }
+
+            item_awaiter(const item_awaiter&) = delete;
+            item_awaiter& operator=(const item_awaiter&) = delete;
+
+            /**
+                \brief Stops waiting if the coroutine is destroyed while it is suspended.
+            */
+            ~item_awaiter()
+            {
+                m_ring_buffer.cancel(m_waiter);
+            }
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                return m_ring_buffer.suspend(m_waiter, handle);
+            }
+
+            value_type await_resume()
+            {
+                return std::move(m_waiter.items.front());
+            }
+
+        private:
+            async_large_ring_buffer& m_ring_buffer;
+            waiter m_waiter;
+        };
+
+        /**
+            \brief Awaitable returned by next_batch(), co_await delivers at least one item.
+        */
+        class batch_awaiter
+        {
+        public:
+            /**
+                \brief Constructs an awaiter.
+                \param[in] ring_buffer  The ring buffer to take the items from.
+                \param[in] max_count    The maximum number of items to take.
+            */
+            batch_awaiter(async_large_ring_buffer& ring_buffer, size_t max_count)
+                : m_ring_buffer(ring_buffer)
+            {
+                m_waiter.max_count = max_count;
+            }
+
+            batch_awaiter(const batch_awaiter&) = delete;
+            batch_awaiter& operator=(const batch_awaiter&) = delete;
+
+            /**
+                \brief Stops waiting if the coroutine is destroyed while it is suspended.
+            */
+            ~batch_awaiter()
+            {
+                m_ring_buffer.cancel(m_waiter);
+            }
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                return m_ring_buffer.suspend(m_waiter, handle);
+            }
+
+            std::vector<value_type> await_resume()
+            {
+                return std::move(m_waiter.items);
+            }
+
+        private:
+            async_large_ring_buffer& m_ring_buffer;
+            waiter m_waiter;
+        };
+
+        /**
+            \brief Constructs a ring buffer object and configures it's size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] executor              The function that resumes waiting coroutines, resumes them directly if empty.
+        */
+        async_large_ring_buffer(size_t number_of_segments, size_t segment_size, executor_type executor = executor_type())
+            : m_ring_buffer(number_of_segments, segment_size)
+            , m_executor(std::move(executor))
+        {
+        }
+
+        async_large_ring_buffer(const async_large_ring_buffer&) = delete;
+        async_large_ring_buffer& operator=(const async_large_ring_buffer&) = delete;
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_ring_buffer.size();
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_ring_buffer.empty();
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer and resumes a waiting coroutine.
+                   Overwrites an item at the front if the ring buffer is full.
+            \param[in] item     The item to add.
+        */
+        void push_back(const value_type& item)
+        {
+            modify([&item](ring_buffer_type& ring_buffer)
+            {
+                ring_buffer.push_back(item);
+            });
+        }
+
+        /**
+            \brief Calls a function with the locked ring buffer and resumes waiting coroutines afterwards.
+            \param[in] function     The function called with a reference to the ring buffer.
+        */
+        template <typename function_type>
+        void modify(function_type function)
+        {
+            std::vector<std::coroutine_handle<> > ready;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                function(m_ring_buffer);
+                while (!m_waiters.empty() && !m_ring_buffer.empty())
+                {
+                    waiter& next_waiter = *m_waiters.front();
+                    take_items(next_waiter);
+                    ready.push_back(next_waiter.handle);
+                    m_waiters.pop_front();
+                }
+            }
+            for (std::coroutine_handle<> handle : ready)
+            {
+                if (m_executor)
+                {
+                    m_executor(handle);
+                }
+                else
+                {
+                    handle.resume();
+                }
+            }
+        }
+
+        /**
+            \brief Removes the item at the front of the ring buffer if there is one.
+            \param[out] item    Receives the removed item.
+            \return True if an item was removed.
+        */
+        bool try_pop_front(value_type& item)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_ring_buffer.empty())
+            {
+                return false;
+            }
+            item = m_ring_buffer.front();
+            m_ring_buffer.pop_front();
+            return true;
+        }
+
+        /**
+            \brief Returns an awaitable that removes the item at the front, suspends until an item is available.
+            \return The awaitable, co_await delivers the item.
+        */
+        item_awaiter next()
+        {
+            return item_awaiter(*this);
+        }
+
+        /**
+            \brief Returns an awaitable that removes up to max_count items at the front, suspends until an item is available.
+            \param[in] max_count    The maximum number of items, must not be zero.
+            \return The awaitable, co_await delivers the items.
+        */
+        batch_awaiter next_batch(size_t max_count)
+        {
+            return batch_awaiter(*this, max_count);
+        }
+
+    private:
+        // takes the items directly or registers the waiter, returns true if the coroutine stays suspended
+        bool suspend(waiter& new_waiter, std::coroutine_handle<> handle)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_waiters.empty() && !m_ring_buffer.empty())
+            {
+                take_items(new_waiter);
+                return false;
+            }
+            new_waiter.handle = handle;
+            m_waiters.push_back(&new_waiter);
+            return true;
+        }
+
+        // removes a waiter that has not been resumed yet
+        void cancel(waiter& old_waiter)
+        {
+            if (!old_waiter.handle)
+            {
+                //never suspended
+                return;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const typename std::deque<waiter*>::iterator position = std::find(m_waiters.begin(), m_waiters.end(), &old_waiter);
+            if (position != m_waiters.end())
+            {
+                m_waiters.erase(position);
+            }
+        }
+
+        void take_items(waiter& next_waiter)
+        {
+            assert(next_waiter.max_count);
+            const size_t count = next_waiter.max_count < m_ring_buffer.size() ? next_waiter.max_count : m_ring_buffer.size();
+            next_waiter.items.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                next_waiter.items.push_back(m_ring_buffer[i]);
+            }
+            m_ring_buffer.release_front(count);
+        }
+
+        mutable std::mutex m_mutex;
+        std::deque<waiter*> m_waiters;
+        ring_buffer_type m_ring_buffer;
+        executor_type m_executor;
+    };
+}
@@ -0,0 +1,252 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains a thread safe large ring buffer with blocking and timed waits for consumers
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A thread safe wrapper of a large ring buffer that lets consumers wait for items.
+
+        All operations lock a mutex, which does not enter the kernel while it is not contended.
+        The smallest size waiting consumers wait for is stored, so a producer only notifies the
+        condition variable when the ring buffer reaches that size. Adding items therefore does not
+        cause a system call as long as no consumer is blocked or waits for more items.
+    */
+    template <typename value_type, typename ring_buffer_type = large_ring_buffer<value_type> >
+    class blocking_large_ring_buffer
+    {
+    public:
+        /**
+            \brief Constructs a ring buffer object.
+        */
+        blocking_large_ring_buffer() = default;
+
+        /**
+            \brief Constructs a ring buffer object and configures it's size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+        */
+        blocking_large_ring_buffer(size_t number_of_segments, size_t segment_size)
+            : m_ring_buffer(number_of_segments, segment_size)
+        {
+        }
+
+        blocking_large_ring_buffer(const blocking_large_ring_buffer&) = delete;
+        blocking_large_ring_buffer& operator=(const blocking_large_ring_buffer&) = delete;
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_ring_buffer.size();
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_ring_buffer.empty();
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer and wakes waiting consumers.
+                   Overwrites an item at the front if the ring buffer is full.
+            \param[in] item     The item to add.
+        */
+        void push_back(const value_type& item)
+        {
+            modify([&item](ring_buffer_type& ring_buffer)
+            {
+                ring_buffer.push_back(item);
+            });
+        }
+
+        /**
+            \brief Calls a function with the locked ring buffer and wakes waiting consumers afterwards.
+            \param[in] function     The function called with a reference to the ring buffer,
+                                    e.g. to add a batch of items with reserve_back() and commit_back().
+        */
+        template <typename function_type>
+        void modify(function_type function)
+        {
+            bool notify = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                function(m_ring_buffer);
+                if (m_ring_buffer.size() >= m_awaited_size)
+                {
+                    //woken consumers that wait for more items register their size again
+                    notify = true;
+                    m_awaited_size = no_awaited_size;
+                }
+            }
+            if (notify)
+            {
+                m_condition.notify_all();
+            }
+        }
+
+        /**
+            \brief Removes the item at the front of the ring buffer if there is one.
+            \param[out] item    Receives the removed item.
+            \return True if an item was removed.
+        */
+        bool try_pop_front(value_type& item)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_ring_buffer.empty())
+            {
+                return false;
+            }
+            item = m_ring_buffer.front();
+            m_ring_buffer.pop_front();
+            return true;
+        }
+
+        /**
+            \brief Waits until an item is available and removes the item at the front of the ring buffer.
+            \param[out] item    Receives the removed item.
+            \param[in] timeout  The maximum time to wait, duration::max() waits without a limit.
+            \return True if an item was removed, false if the timeout expired.
+        */
+        template <typename rep_type, typename period_type>
+        bool wait_pop_front(value_type& item, const std::chrono::duration<rep_type, period_type>& timeout)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!wait(lock, 1, timeout))
+            {
+                return false;
+            }
+            item = m_ring_buffer.front();
+            m_ring_buffer.pop_front();
+            return true;
+        }
+
+        /**
+            \brief Waits until the ring buffer stores at least the given number of items.
+            \param[in] count    The number of items to wait for, limited to get_max_size().
+            \param[in] timeout  The maximum time to wait, duration::max() waits without a limit.
+            \return True if the ring buffer stores at least count items, false if the timeout expired.
+        */
+        template <typename rep_type, typename period_type>
+        bool wait_for_size(size_t count, const std::chrono::duration<rep_type, period_type>& timeout)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            return wait(lock, count, timeout);
+        }
+
+        /**
+            \brief Calls a function with the locked ring buffer without waking consumers, e.g. to remove a batch of items.
+            \param[in] function     The function called with a reference to the ring buffer.
+        */
+        template <typename function_type>
+        void access(function_type function)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            function(m_ring_buffer);
+        }
+
+    private:
+        template <typename rep_type, typename period_type>
+        bool wait(std::unique_lock<std::mutex>& lock, size_t count, const std::chrono::duration<rep_type, period_type>& timeout)
+        {
+            if (m_ring_buffer.get_max_size() && count > m_ring_buffer.get_max_size())
+            {
+                count = m_ring_buffer.get_max_size();
+            }
+            if (m_ring_buffer.size() >= count)
+            {
+                return true;
+            }
+            //producers only notify when the smallest awaited size is reached
+            const std::chrono::steady_clock::time_point deadline = get_deadline(timeout);
+            bool result = true;
+            ++m_waiting_consumers;
+            while (m_ring_buffer.size() < count)
+            {
+                if (count < m_awaited_size)
+                {
+                    m_awaited_size = count;
+                }
+                if (m_condition.wait_until(lock, deadline) == std::cv_status::timeout)
+                {
+                    result = m_ring_buffer.size() >= count;
+                    break;
+                }
+            }
+            if (--m_waiting_consumers == 0)
+            {
+                m_awaited_size = no_awaited_size;
+            }
+            return result;
+        }
+
+        template <typename rep_type, typename period_type>
+        static std::chrono::steady_clock::time_point get_deadline(const std::chrono::duration<rep_type, period_type>& timeout)
+        {
+            //compared as floating point, so long timeouts like duration::max() do not overflow
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            const std::chrono::duration<double> max_timeout = std::chrono::steady_clock::time_point::max() - now;
+            if (std::chrono::duration<double>(timeout) >= max_timeout)
+            {
+                return std::chrono::steady_clock::time_point::max();
+            }
+            return now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+        }
+
+        static const size_t no_awaited_size = static_cast<size_t>(-1);
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        size_t m_waiting_consumers = 0;
+        size_t m_awaited_size = no_awaited_size; // the smallest size a waiting consumer waits for
+        ring_buffer_type m_ring_buffer;
+    };
+}
@@ -0,0 +1,322 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains a large ring buffer that broadcasts every item to multiple consumers with independent cursors
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A thread safe large ring buffer where each registered consumer reads every item at its own pace.
+
+        The producer stores each item once. Every consumer has a cursor that advances independently.
+        Items are removed from the front, and their segments are freed, once all consumers have read
+        them, so memory use is gated by the slowest consumer.
+        If the ring buffer is full and the slowest consumer has not read the item at the front,
+        the lag policy decides whether new items are rejected or the slow consumers are dropped.
+    */
+    template <typename value_type, typename ring_buffer_type = large_ring_buffer<value_type> >
+    class broadcast_large_ring_buffer
+    {
+    public:
+        /**
+            \brief Identifies a registered consumer.
+
+            The lower 32 bits are the slot of the consumer, the upper 32 bits count how often the slot
+            has been reused, so the id of a removed consumer is rejected once its slot is reused.
+        */
+        typedef std::uint64_t consumer_id;
+
+        /**
+            \brief Decides what happens if a new item would overwrite an item a consumer has not read.
+        */
+        enum class lag_policy
+        {
+            reject_new_items,   ///< push_back() returns false, the producer has to retry later.
+            drop_slow_consumers ///< The consumers that have not read the item at the front are removed.
+        };
+
+        /**
+            \brief Constructs a ring buffer object and configures it's size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] policy                The lag policy.
+        */
+        broadcast_large_ring_buffer(size_t number_of_segments, size_t segment_size, lag_policy policy = lag_policy::reject_new_items)
+            : m_ring_buffer(number_of_segments, segment_size)
+            , m_policy(policy)
+        {
+        }
+
+        broadcast_large_ring_buffer(const broadcast_large_ring_buffer&) = delete;
+        broadcast_large_ring_buffer& operator=(const broadcast_large_ring_buffer&) = delete;
+
+        /**
+            \brief Registers a consumer, reusing the slot of a removed consumer if there is one.
+            \param[in] from_oldest  If true the consumer starts with the oldest stored item, otherwise with the next item added.
+            \return The id of the consumer.
+        */
+        consumer_id add_consumer(bool from_oldest = false)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t slot = 0;
+            while (slot < m_consumers.size() && !m_consumers[slot].removed)
+            {
+                ++slot;
+            }
+            if (slot == m_consumers.size())
+            {
+                m_consumers.push_back(consumer());
+            }
+            else
+            {
+                ++m_consumers[slot].generation;
+            }
+            consumer& new_consumer = m_consumers[slot];
+            new_consumer.sequence = from_oldest ? m_first_sequence : get_end_sequence();
+            new_consumer.active = true;
+            new_consumer.dropped = false;
+            new_consumer.removed = false;
+            release_read_items();
+            return (static_cast<consumer_id>(new_consumer.generation) << 32) | slot;
+        }
+
+        /**
+            \brief Unregisters a consumer, items only it has not read yet are removed.
+            \param[in] id   The id of the consumer.
+
+            The slot of the consumer is reused by the next consumer added, dropped consumers keep
+            their slot until they are removed.
+        */
+        void remove_consumer(consumer_id id)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            consumer& reader = get_consumer(id);
+            reader.active = false;
+            reader.dropped = false;
+            reader.removed = true;
+            release_read_items();
+        }
+
+        /**
+            \brief Returns true if the consumer was removed because it did not keep up.
+            \param[in] id   The id of the consumer.
+            \return True if the consumer was dropped by the lag policy.
+        */
+        bool is_dropped(consumer_id id) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return get_consumer(id).dropped;
+        }
+
+        /**
+            \brief Returns the number of items currently stored, i.e. not read by all consumers.
+            \return The number of items currently stored.
+        */
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_ring_buffer.size();
+        }
+
+        /**
+            \brief Returns the number of items a consumer has not read yet.
+            \param[in] id   The id of the consumer.
+            \return The number of items available to the consumer, 0 if it is not registered.
+        */
+        size_t get_available(consumer_id id) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const consumer& reader = get_consumer(id);
+            return reader.active ? static_cast<size_t>(get_end_sequence() - reader.sequence) : 0;
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+            \param[in] item     The item to add.
+            \return False if the item was rejected because of the lag policy.
+        */
+        bool push_back(const value_type& item)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_ring_buffer.full())
+            {
+                //the front is only stored while a consumer has not read it
+                if (get_slowest_sequence() == m_first_sequence && m_policy == lag_policy::reject_new_items)
+                {
+                    return false;
+                }
+                for (consumer& reader : m_consumers)
+                {
+                    if (reader.active && reader.sequence == m_first_sequence)
+                    {
+                        reader.active = false;
+                        reader.dropped = true;
+                    }
+                }
+                ++m_first_sequence;
+            }
+            m_ring_buffer.push_back(item);
+            release_read_items();
+            return true;
+        }
+
+        /**
+            \brief Copies the next item of a consumer and advances its cursor.
+            \param[in] id       The id of the consumer.
+            \param[out] item    Receives the item.
+            \return True if an item was available.
+        */
+        bool try_read(consumer_id id, value_type& item)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            consumer& reader = get_consumer(id);
+            if (!reader.active || reader.sequence == get_end_sequence())
+            {
+                return false;
+            }
+            item = m_ring_buffer[static_cast<size_t>(reader.sequence - m_first_sequence)];
+            ++reader.sequence;
+            release_read_items();
+            return true;
+        }
+
+        /**
+            \brief Calls a function for the next items of a consumer and advances its cursor.
+            \param[in] id           The id of the consumer.
+            \param[in] max_count    The maximum number of items.
+            \param[in] function     The function called with a const reference to each item, the items are not copied.
+            \return The number of items read.
+        */
+        template <typename function_type>
+        size_t read(consumer_id id, size_t max_count, function_type function)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            consumer& reader = get_consumer(id);
+            if (!reader.active)
+            {
+                return 0;
+            }
+            const size_t available = static_cast<size_t>(get_end_sequence() - reader.sequence);
+            const size_t count = max_count < available ? max_count : available;
+            const ring_buffer_type& items = m_ring_buffer;
+            items.for_each(static_cast<size_t>(reader.sequence - m_first_sequence), count, function);
+            reader.sequence += count;
+            release_read_items();
+            return count;
+        }
+
+    private:
+        struct consumer
+        {
+            std::uint64_t sequence = 0; // the sequence number of the next item to read
+            std::uint32_t generation = 0; // incremented when the slot is reused
+            bool active = false;
+            bool dropped = false;
+            bool removed = false; // the slot can be reused
+        };
+
+        consumer& get_consumer(consumer_id id)
+        {
+            return m_consumers[get_slot(id)];
+        }
+
+        const consumer& get_consumer(consumer_id id) const
+        {
+            return m_consumers[get_slot(id)];
+        }
+
+        size_t get_slot(consumer_id id) const
+        {
+            //ids of consumers whose slot has been reused are stale
+            const std::uint64_t slot = id & 0xffffffffu;
+            if (slot >= m_consumers.size() || m_consumers[static_cast<size_t>(slot)].generation != (id >> 32))
+            {
+                throw std::range_error("Unknown consumer.");
+            }
+            return static_cast<size_t>(slot);
+        }
+
+        std::uint64_t get_end_sequence() const
+        {
+            return m_first_sequence + m_ring_buffer.size();
+        }
+
+        // the sequence of the oldest item not read by all consumers, the end sequence if there is no consumer
+        std::uint64_t get_slowest_sequence() const
+        {
+            std::uint64_t result = get_end_sequence();
+            for (const consumer& reader : m_consumers)
+            {
+                if (reader.active && reader.sequence < result)
+                {
+                    result = reader.sequence;
+                }
+            }
+            return result;
+        }
+
+        void release_read_items()
+        {
+            bool any_active = false;
+            for (const consumer& reader : m_consumers)
+            {
+                any_active = any_active || reader.active;
+            }
+            if (!any_active)
+            {
+                //without consumers items are kept until they are overwritten
+                return;
+            }
+            const std::uint64_t slowest = get_slowest_sequence();
+            m_ring_buffer.release_front(static_cast<size_t>(slowest - m_first_sequence));
+            m_first_sequence = slowest;
+        }
+
+        mutable std::mutex m_mutex;
+        ring_buffer_type m_ring_buffer;
+        lag_policy m_policy;
+        std::vector<consumer> m_consumers;
+        std::uint64_t m_first_sequence = 0; // the sequence number of the item at the front
+    };
+}
@@ -0,0 +1,242 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains a large ring buffer that limits the memory used by its items to a byte budget
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include <stdexcept>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A large ring buffer that removes items at the front once their memory exceeds a byte budget.
+
+        The memory of an item is reported by size_functor_type, e.g. sizeof(std::string) + capacity().
+        Adding an item removes items at the front until the new item fits into the budget, in
+        addition to the limit by number_of_segments * segment_size items. The size of an item is
+        measured on the stored copy, which can differ from the added item, e.g. in its capacity.
+        Removed items are passed to the clear handler; the default handler swaps them with a
+        default constructed value, so the memory held by removed items is actually freed.
+
+        Items can only be accessed read only, so the reported sizes stay valid.
+    */
+    template <typename value_type, typename size_functor_type, typename clear_handler_type = swap_default_clear_handler<value_type> >
+    class budget_large_ring_buffer
+    {
+    public:
+        /**
+            \brief Constructs a ring buffer object.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] byte_budget           The maximum number of bytes used by the stored items.
+            \param[in] size_functor          Returns the number of bytes used by an item.
+        */
+        budget_large_ring_buffer(size_t number_of_segments, size_t segment_size, size_t byte_budget, size_functor_type size_functor = size_functor_type())
+            : m_ring_buffer(number_of_segments, segment_size)
+            , m_size_functor(size_functor)
+            , m_byte_budget(byte_budget)
+        {
+        }
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            return m_ring_buffer.size();
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            return m_ring_buffer.empty();
+        }
+
+        /**
+            \brief Returns the maximum number of items that can be stored in the ring buffer.
+            \return The maximum number of items that can be stored in the ring buffer.
+        */
+        size_t get_max_size() const
+        {
+            return m_ring_buffer.get_max_size();
+        }
+
+        /**
+            \brief Returns the number of bytes used by the stored items as reported by the size functor.
+            \return The number of bytes used by the stored items.
+        */
+        size_t get_used_bytes() const
+        {
+            return m_used_bytes;
+        }
+
+        /**
+            \brief Returns the maximum number of bytes used by the stored items.
+            \return The byte budget.
+        */
+        size_t get_byte_budget() const
+        {
+            return m_byte_budget;
+        }
+
+        /**
+            \brief Changes the byte budget and removes items at the front until the stored items fit.
+            \param[in] byte_budget   The maximum number of bytes used by the stored items.
+        */
+        void set_byte_budget(size_t byte_budget)
+        {
+            m_byte_budget = byte_budget;
+            make_room(0);
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        const value_type& operator[](size_t index) const
+        {
+            return m_ring_buffer[index];
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+            Throws an exception if the index is out of bounds.
+        */
+        const value_type& at(size_t index) const
+        {
+            return m_ring_buffer.at(index);
+        }
+
+        /**
+            \brief Returns the item at the front of the ring buffer.
+            \return The item at the front of the ring buffer.
+        */
+        const value_type& front() const
+        {
+            return m_ring_buffer.front();
+        }
+
+        /**
+            \brief Returns the item at the back of the ring buffer.
+            \return The item at the back of the ring buffer.
+        */
+        const value_type& back() const
+        {
+            return m_ring_buffer.back();
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+                   Removes items at the front until the item fits into the budget and the maximum size.
+            \param[in] item     The item to add.
+            Throws an exception if the item alone exceeds the budget, the ring buffer is not changed in this case.
+            If the stored copy alone exceeds the budget, it is kept as the only item.
+        */
+        void push_back(const value_type& item)
+        {
+            const size_t item_bytes = m_size_functor(item);
+            if (item_bytes > m_byte_budget)
+            {
+                throw std::range_error("Item exceeds the byte budget of the ring buffer.");
+            }
+            make_room(item_bytes);
+            if (m_ring_buffer.full())
+            {
+                pop_front();
+            }
+            m_ring_buffer.push_back(item);
+            //the stored copy is measured, so pop_front() and pop_back() subtract the same size
+            m_used_bytes += m_size_functor(m_ring_buffer.back());
+            while (m_ring_buffer.size() > 1 && m_used_bytes > m_byte_budget)
+            {
+                pop_front();
+            }
+        }
+
+        /**
+            \brief Removes an item at the front of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_front()
+        {
+            m_used_bytes -= m_size_functor(m_ring_buffer.front());
+            m_ring_buffer.pop_front();
+        }
+
+        /**
+            \brief Removes an item at the back of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_back()
+        {
+            m_used_bytes -= m_size_functor(m_ring_buffer.back());
+            m_ring_buffer.pop_back();
+        }
+
+        /**
+            \brief Removes all items.
+        */
+        void clear()
+        {
+            m_ring_buffer.clear();
+            m_used_bytes = 0;
+        }
+
+    private:
+        // removes items at the front until additional_bytes fit into the budget
+        void make_room(size_t additional_bytes)
+        {
+            while (!m_ring_buffer.empty() && m_used_bytes + additional_bytes > m_byte_budget)
+            {
+                pop_front();
+            }
+        }
+
+        large_ring_buffer<value_type, clear_handler_type> m_ring_buffer;
+        size_functor_type m_size_functor;
+        size_t m_byte_budget = 0;
+        size_t m_used_bytes = 0;
+    };
+}
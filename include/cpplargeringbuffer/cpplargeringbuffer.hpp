@@ -60,12 +60,47 @@ items in a ring buffer with index based access, e.g. for log messages.
   that are updated continuously but shall not be moved in memory.
 */
 #pragma once
+#include <algorithm>
+#include <array>
 #include <vector>
+#include <cstddef>
 #include <stdexcept>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <thread>
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#endif
 
 namespace cpplargeringbuffer
 {
+    /**
+        \brief Hints the processor to load the cache line at the given address for reading.
+        \param[in] address  The address to load, may be invalid.
+    */
+    inline void prefetch(const void* address)
+    {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void)address;
+#endif
+    }
+
     /**
         \brief A clear handler that does nothing (default).
 
@@ -82,6 +117,13 @@ namespace cpplargeringbuffer
         static void clear(value_type&)
         {
         }
+
+        /**
+            \brief Does nothing.
+        */
+        static void clear_range(value_type*, size_t)
+        {
+        }
     };
 
     /**
@@ -103,6 +145,67 @@ namespace cpplargeringbuffer
         {
             v = value_type();
         }
+
+        /**
+            \brief Replaces unused objects with default constructed ones.
+            \param[in] items    The first object to clear.
+            \param[in] count    The number of objects.
+
+            Trivial types are value initialized to zero, so their memory is set to zero at once.
+        */
+        static void clear_range(value_type* items, size_t count)
+        {
+            clear_range(items, count, std::integral_constant<bool, std::is_trivially_copyable<value_type>::value && std::is_trivially_default_constructible<value_type>::value>());
+        }
+
+    private:
+        static void clear_range(value_type* items, size_t count, std::true_type)
+        {
+            std::memset(static_cast<void*>(items), 0, count * sizeof(value_type));
+        }
+
+        static void clear_range(value_type* items, size_t count, std::false_type)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                items[i] = value_type();
+            }
+        }
+    };
+
+    /**
+        \brief A clear handler that swaps unused objects with a default constructed instance.
+
+        Unlike assign_default_clear_handler, the memory held by the object is freed, e.g. the
+        capacity of a std::string or a std::vector, because assigning keeps it.
+    */
+    template <typename value_type>
+    class swap_default_clear_handler
+    {
+    public:
+        /**
+            \brief Swaps the unused object with a default constructed one that is destroyed.
+            \param[in] v    The value to clear.
+        */
+        static void clear(value_type& v)
+        {
+            value_type temp;
+            using std::swap;
+            swap(v, temp);
+        }
+
+        /**
+            \brief Swaps the unused objects with default constructed ones that are destroyed.
+            \param[in] items    The first object to clear.
+            \param[in] count    The number of objects.
+        */
+        static void clear_range(value_type* items, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                clear(items[i]);
+            }
+        }
     };
 
     /**
@@ -123,255 +226,1821 @@ namespace cpplargeringbuffer
         {
             v.clear();
         }
+
+        /**
+            \brief Calls the clear method of each object.
+            \param[in] items    The first object to clear.
+            \param[in] count    The number of objects.
+        */
+        static void clear_range(value_type* items, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                items[i].clear();
+            }
+        }
     };
 
+    /**
+        \brief Clears a range of items with the clear_range() method of a clear handler.
+        \param[in] items    The first item to clear.
+        \param[in] count    The number of items.
+    */
+    template <typename clear_handler_type, typename value_type>
+    auto clear_items(value_type* items, size_t count, int) -> decltype(clear_handler_type::clear_range(items, count), void())
+    {
+        clear_handler_type::clear_range(items, count);
+    }
 
     /**
-        \brief A ring buffer implementation for a large number of items.
+        \brief Clears a range of items one by one, used for clear handlers without a clear_range() method.
+        \param[in] items    The first item to clear.
+        \param[in] count    The number of items.
+    */
+    template <typename clear_handler_type, typename value_type>
+    void clear_items(value_type* items, size_t count, long)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            clear_handler_type::clear(items[i]);
+        }
+    }
 
-         Implements a storage for a stream of n objects with index based access
-         that are updated continuously but shall not be moved in memory.
+    /**
+        \brief Copies trivially copyable items with memcpy.
     */
-    template <typename value_type, typename clear_handler_type = noop_clear_handler<value_type> >
-    class large_ring_buffer
+    template <typename value_type>
+    void copy_items(value_type* destination, const value_type* source, size_t count, std::true_type)
+    {
+        if (count)
+        {
+            std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(value_type));
+        }
+    }
+
+    /**
+        \brief Copies items by assignment.
+    */
+    template <typename value_type>
+    void copy_items(value_type* destination, const value_type* source, size_t count, std::false_type)
+    {
+        std::copy(source, source + count, destination);
+    }
+
+    /**
+        \brief Copies items, trivially copyable items are copied with memcpy.
+        \param[in] destination  The first item to assign, must not overlap the source items.
+        \param[in] source       The first item to copy.
+        \param[in] count        The number of items.
+    */
+    template <typename value_type>
+    void copy_items(value_type* destination, const value_type* source, size_t count)
+    {
+        copy_items(destination, source, count, std::is_trivially_copyable<value_type>());
+    }
+
+    /**
+        \brief The assumed size of a cache line in bytes.
+    */
+    static const size_t cache_line_size = 64;
+
+    /**
+        \brief An allocator that aligns allocations to a given boundary.
+
+        Can be used as allocator of large_ring_buffer to align every segment to a cache line
+        or to the alignment required by SIMD instructions.
+        \code
+        large_ring_buffer<float, noop_clear_handler<float>, aligned_allocator<float, 32> > ringbuffer(100, 1024);
+        \endcode
+    */
+    template <typename value_type_, size_t alignment = cache_line_size>
+    class aligned_allocator
     {
+        static_assert(alignment != 0 && (alignment & (alignment - 1)) == 0, "The alignment must be a power of two.");
+        static_assert(alignment >= alignof(void*) && alignment >= alignof(value_type_), "The alignment must not be less than the alignment of a pointer and of value_type.");
     public:
         /**
-            \brief Constructs a ring buffer object.
+            \brief The type of the allocated items.
         */
-        large_ring_buffer() = default;
+        typedef value_type_ value_type;
 
         /**
-            \brief Constructs a ring buffer object and configures it's size parameters.
-            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
-            \param[in] segment_size          The size of a segment in number of items stored.
-                                             All items are constructed and destroyed at the same time when needed.
-
-            number_of_segments * segment_size can be used to compute the number of items that can be stored.
+            \brief Provides the allocator type for another item type.
         */
-        large_ring_buffer(size_t number_of_segments, size_t segment_size)
+        template <typename other_type>
+        struct rebind
         {
-            discard_and_change_configuration(number_of_segments, segment_size);
-        }
+            typedef aligned_allocator<other_type, alignment> other;
+        };
 
         /**
-            \brief Destroys a ring buffer object.
+            \brief Constructs an allocator.
         */
-        ~large_ring_buffer() = default;
+        aligned_allocator() = default;
 
         /**
-            \brief Clears a ring buffer object.
-            \post
-            - The clear method has been called for items stored in the ring buffer.
-            - Segment buffers have been cleared.
+            \brief Constructs an allocator for another item type.
         */
-        void clear()
+        template <typename other_type>
+        aligned_allocator(const aligned_allocator<other_type, alignment>&)
         {
-            const size_t item_count = size();
-            for (size_t i = 0; i < item_count; ++i)
-            {
-                pop_front();
-            }
-
-            for (auto& segment : m_segments)
-            {
-                //completely remove the segment and free the memory
-                segment.clear();
-                std::vector<value_type> temp;
-                segment.swap(temp);
-            }
         }
 
         /**
-            \brief Returns the number of items currently stored in the ring buffer.
-            \return The number of items currently stored in the ring buffer.
+            \brief Allocates memory for the given number of items.
+            \param[in] count    The number of items.
+            \return The allocated memory, aligned to alignment bytes.
+            Throws std::bad_alloc if the memory cannot be allocated or its size cannot be represented.
         */
-        size_t size() const
+        value_type* allocate(size_t count)
         {
-            size_t result = 0;
-            if (m_end_index == m_start_index)
+            if (count > (std::numeric_limits<size_t>::max() - alignment - sizeof(void*)) / sizeof(value_type))
             {
-                if (m_full)
-                {
-                    result = m_max_size;
-                }
-                else
-                {
-                    result = 0;
-                }
-            }
-            else if (m_end_index >= m_start_index)
-            {
-                result = m_end_index - m_start_index;
-            }
-            else
-            {
-                result = (m_max_size - m_start_index) + m_end_index;
+                throw std::bad_alloc();
             }
-            return result;
+            //over allocate and store the start of the allocation in front of the aligned items
+            char* allocation = static_cast<char*>(::operator new(count * sizeof(value_type) + alignment + sizeof(void*)));
+            const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(allocation + sizeof(void*));
+            char* aligned = allocation + sizeof(void*) + (alignment - first % alignment) % alignment;
+            reinterpret_cast<void**>(aligned)[-1] = allocation;
+            return reinterpret_cast<value_type*>(aligned);
         }
 
         /**
-            \brief Returns true if no items are currently stored in the ring buffer.
-            \return True if no items are currently stored in the ring buffer.
+            \brief Frees memory allocated with allocate().
+            \param[in] items    The allocated memory.
         */
-        bool empty() const
+        void deallocate(value_type* items, size_t)
         {
-            return !m_full && m_end_index == m_start_index;
+            ::operator delete(reinterpret_cast<void**>(items)[-1]);
         }
 
         /**
-            \brief Returns true if the maximum configured number of items are currently stored in the ring buffer.
-            \return True if the maximum configured number of items are currently stored in the ring buffer.
+            \brief Returns true, memory allocated by one allocator can be freed by any other one.
+            \return True.
         */
-        bool full() const
+        template <typename other_type>
+        bool operator==(const aligned_allocator<other_type, alignment>&) const
         {
-            return m_full;
+            return true;
         }
 
         /**
-            \brief Returns the maximum configured number of items that can be stored in the ring buffer.
-            \return The maximum configured number of items that can be stored in the ring buffer.
+            \brief Returns false, memory allocated by one allocator can be freed by any other one.
+            \return False.
         */
-        size_t get_max_size() const
+        template <typename other_type>
+        bool operator!=(const aligned_allocator<other_type, alignment>&) const
         {
-            return m_max_size;
+            return false;
         }
+    };
+
+    /**
+        \brief Tells whether all zero bytes are the value initialized state of a type.
+
+        True for arithmetic and enumeration types. Specialize it as std::true_type for other trivially default
+        constructible types whose value initialized state is all zero bytes, e.g. structs of arithmetic members,
+        to let zero_page_allocator skip their initialization. Not true for pointers to data members,
+        which are -1 when value initialized on common platforms.
+    */
+    template <typename value_type>
+    struct is_zero_initialized : std::integral_constant<bool, std::is_arithmetic<value_type>::value || std::is_enum<value_type>::value>
+    {
+    };
+
+    /**
+        \brief An allocator that gets zeroed memory from calloc and skips value initialization of types that are zero initialized.
+
+        Large calloc allocations are mapped to zero pages by the operating system, so allocating a segment
+        of a type for which is_zero_initialized is true neither writes nor touches its memory. The items are
+        the same as with std::allocator, other types are value initialized as usual.
+        Physical memory is used when an item is stored for the first time, so use prefault() to make the
+        segments resident at startup, it writes every page explicitly.
+        The alignment of value_type must not exceed the alignment of std::max_align_t provided by calloc.
+        Only use it with containers that construct items in freshly allocated memory, like the segment tables.
+    */
+    template <typename value_type_>
+    class zero_page_allocator
+    {
+    public:
+        /**
+            \brief The type of the allocated items.
+        */
+        typedef value_type_ value_type;
 
         /**
-            \brief Returns the size of a segment.
-            \return The size of a segment.
+            \brief Provides the allocator type for another item type.
         */
-        size_t get_segment_size() const
+        template <typename other_type>
+        struct rebind
         {
-            return m_segment_size;
-        }
+            typedef zero_page_allocator<other_type> other;
+        };
 
         /**
-            \brief Returns the count of segments configured.
-            \return The count of segments configured.
+            \brief Constructs an allocator.
         */
-        size_t get_segment_count() const
+        zero_page_allocator() = default;
+
+        /**
+            \brief Constructs an allocator for another item type.
+        */
+        template <typename other_type>
+        zero_page_allocator(const zero_page_allocator<other_type>&)
         {
-            if (m_max_size && m_segment_size)
-            {
-                return m_max_size / m_segment_size;
-            }
-            return 0;
         }
 
         /**
-            \brief Returns the count of segments that are allocated.
-            \return The count of segments that are allocated.
+            \brief Allocates zeroed memory for the given number of items.
+            \param[in] count    The number of items.
+            \return The allocated memory.
+            Throws std::bad_alloc if the memory cannot be allocated.
         */
-        size_t get_used_segments() const
+        value_type* allocate(size_t count)
         {
-            size_t result = 0;
-            for (const auto& segment : m_segments)
+            static_assert(alignof(value_type) <= alignof(std::max_align_t), "zero_page_allocator requires a value_type that is not over-aligned.");
+            void* result = std::calloc(count, sizeof(value_type));
+            if (!result)
             {
-                if (!segment.empty())
-                {
-                    ++result;
-                }
+                throw std::bad_alloc();
             }
-            return result;
+            return static_cast<value_type*>(result);
         }
 
         /**
-            \brief Destroyes all stored objects and configures the size parameters.
-            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
-            \param[in] segment_size          The size of a segment in number of items stored.
-                                             All items are constructed and destroyed at the same time when needed.
-
-            number_of_segments * segment_size can be used to compute the number of items that can be stored.
-            \post
-            - All items stored are destroyed.
-            - Clear is not called on the items.
-            - The new configuration is applied.
+            \brief Frees memory allocated with allocate().
+            \param[in] items    The allocated memory.
         */
-        void discard_and_change_configuration(size_t number_of_segments, size_t segment_size)
+        void deallocate(value_type* items, size_t)
         {
-            m_segments.clear();
-            m_start_index = 0;
-            m_end_index = 0;
-            m_max_size = 0;
-            m_segment_size = 0;
-            m_full = false;
-            if (number_of_segments == 0 || segment_size == 0)
-            {
-                //nothing to do here; usable size will be zero
-            }
-            else
-            {
-                m_segment_size = segment_size;
-                m_segments.resize(number_of_segments);
-                m_max_size = number_of_segments * segment_size;
-            }
+            std::free(items);
         }
 
         /**
-            \brief Returns a reference to the item stored at the given index.
-            \param[in] index    The index of the item in the ring buffer.
-            \return The item in the ring buffer at the given index.
+            \brief Value initializes an item, zero initialized types are zero already and are left untouched.
+            \param[in] item     The memory of the item.
         */
-        value_type& operator[](size_t index)
+        template <typename other_type>
+        void construct(other_type* item)
         {
-            size_t internal_index = to_internal_index(index);
-            return get_item(internal_index);
+            construct_default(item, std::integral_constant<bool, is_zero_initialized<other_type>::value && std::is_trivially_default_constructible<other_type>::value>());
         }
 
         /**
-            \brief Returns a reference to the item stored at the given index.
-            \param[in] index    The index of the item in the ring buffer.
-            \return The item in the ring buffer at the given index.
+            \brief Constructs an item from the given arguments.
+            \param[in] item         The memory of the item.
+            \param[in] arguments    The constructor arguments.
         */
-        const value_type& operator[](size_t index) const
+        template <typename other_type, typename... argument_types>
+        void construct(other_type* item, argument_types&&... arguments)
         {
-            size_t internal_index = to_internal_index(index);
-            return get_item(internal_index);
+            ::new (static_cast<void*>(item)) other_type(std::forward<argument_types>(arguments)...);
         }
 
         /**
-            \brief Returns a reference to the item stored at the given index.
-            \param[in] index    The index of the item in the ring buffer.
-            \return The item in the ring buffer at the given index.
-            Throws an exception if the index is out of bounds.
+            \brief Returns true, memory allocated by one allocator can be freed by any other one.
+            \return True.
         */
-        value_type& at(size_t index)
+        template <typename other_type>
+        bool operator==(const zero_page_allocator<other_type>&) const
         {
-            if (index >= size())
-            {
-                throw std::range_error("Ringbuffer index out of bounds.");
-            }
-            size_t internal_index = to_internal_index(index);
-            return get_item(internal_index);
+            return true;
         }
 
         /**
-            \brief Returns a reference to the item stored at the given index.
-            \param[in] index    The index of the item in the ring buffer.
-            \return The item in the ring buffer at the given index.
-            Throws an exception if the index is out of bounds.
+            \brief Returns false, memory allocated by one allocator can be freed by any other one.
+            \return False.
         */
-        const value_type& at(size_t index) const
+        template <typename other_type>
+        bool operator!=(const zero_page_allocator<other_type>&) const
         {
-            if (index >= size())
-            {
-                throw std::range_error("Ringbuffer index out of bounds.");
-            }
-            size_t internal_index = to_internal_index(index);
-            return get_item(internal_index);
+            return false;
+        }
+
+    private:
+        template <typename other_type>
+        static void construct_default(other_type*, std::true_type)
+        {
+            //calloc returned zeroed memory, the same as value initialization
         }
 
+        template <typename other_type>
+        static void construct_default(other_type* item, std::false_type)
+        {
+            ::new (static_cast<void*>(item)) other_type();
+        }
+    };
+
+    /**
+        \brief A segment table with a number of segments and a segment size configured at runtime.
+
+        A segment table stores the segments of a ring buffer and provides the geometry.
+        Segments are allocated and freed by the ring buffer. The memory of a segment
+        is obtained from allocator_type.
+    */
+    template <typename value_type, typename allocator_type = std::allocator<value_type> >
+    class dynamic_segment_table
+    {
+    public:
         /**
-            \brief Adds an item at the back of the ring buffer.
-                   Overwrites an item at the front if the ring buffer is full.
-            \return The last item in the ring buffer, delivers a cached value or a newly created one.
+            \brief The type of a segment, an empty segment is not allocated.
         */
-        value_type& extend_back()
-        {
-            if (m_full)
-            {
+        typedef std::vector<value_type, allocator_type> segment_type;
+
+        /**
+            \brief Handler that takes over a segment whose items are evicted from a full ring buffer.
+            \param[in,out] segment  The evicted segment, swap it with an unallocated segment or with an allocated one of the same size.
+        */
+        typedef std::function<void(segment_type& segment)> handover_handler_type;
+
+        /**
+            \brief Returns the allocator used for the memory of the segments.
+            \return The allocator used for the memory of the segments.
+        */
+        const allocator_type& get_allocator() const
+        {
+            return m_allocator;
+        }
+
+        /**
+            \brief Sets the allocator used for the memory of segments configured afterwards.
+            \param[in] allocator    The allocator.
+        */
+        void set_allocator(const allocator_type& allocator)
+        {
+            m_allocator = allocator;
+        }
+
+        /**
+            \brief Returns the size of a segment.
+            \return The size of a segment.
+        */
+        size_t get_segment_size() const
+        {
+            return m_segment_size;
+        }
+
+        /**
+            \brief Returns the count of segments configured.
+            \return The count of segments configured.
+        */
+        size_t get_segment_count() const
+        {
+            return m_segments.size();
+        }
+
+        /**
+            \brief Returns the maximum configured number of items that can be stored.
+            \return The maximum configured number of items that can be stored.
+        */
+        size_t get_max_size() const
+        {
+            return m_max_size;
+        }
+
+        /**
+            \brief Returns true if the segment at the given index is allocated.
+            \param[in] segment_index    The index of the segment.
+            \return True if the segment at the given index is allocated.
+        */
+        bool is_allocated(size_t segment_index) const
+        {
+            return !m_segments[segment_index].empty();
+        }
+
+        /**
+            \brief Allocates the segment at the given index and constructs its items.
+            \param[in] segment_index    The index of the segment.
+        */
+        void allocate(size_t segment_index)
+        {
+            m_segments[segment_index].resize(get_segment_size());
+        }
+
+        /**
+            \brief Destroys the items of the segment at the given index and frees the memory.
+            \param[in] segment_index    The index of the segment.
+        */
+        void release(size_t segment_index)
+        {
+            //completely remove the segment and free the memory
+            segment_type temp(m_segments[segment_index].get_allocator());
+            m_segments[segment_index].swap(temp);
+        }
+
+        /**
+            \brief Moves the segment at the given index to the retired segments without destroying its items.
+            \param[in] segment_index    The index of the segment, it is unallocated afterwards.
+
+            Retiring does not allocate, space is reserved by reserve_retired(). Retired segments are reused
+            by reuse_retired(), so the list does not grow beyond it. If it is full anyway, e.g. if no space
+            has been reserved, the segment is released immediately.
+        */
+        void retire(size_t segment_index)
+        {
+            if (m_retired.size() == m_retired.capacity())
+            {
+                release(segment_index);
+                return;
+            }
+            m_retired.push_back(segment_type(m_segments[segment_index].get_allocator()));
+            m_retired.back().swap(m_segments[segment_index]);
+        }
+
+        /**
+            \brief Reserves space for one retired segment per segment, so retiring does not allocate.
+        */
+        void reserve_retired()
+        {
+            m_retired.reserve(get_segment_count());
+        }
+
+        /**
+            \brief Moves a retired segment to the unallocated segment at the given index, so it is not allocated again.
+            \param[in] segment_index    The index of the unallocated segment.
+            \return True if a retired segment has been reused, false if the segment must be allocated.
+
+            The items of a retired segment have been cleared by the ring buffer when they were removed.
+        */
+        bool reuse_retired(size_t segment_index)
+        {
+            if (m_retired.empty() || m_retired.back().size() != get_segment_size())
+            {
+                return false;
+            }
+            m_segments[segment_index].swap(m_retired.back());
+            m_retired.pop_back();
+            return true;
+        }
+
+        /**
+            \brief Destroys the items of the retired segments and frees their memory.
+            \return The number of segments freed.
+        */
+        size_t reclaim()
+        {
+            const size_t result = m_retired.size();
+            m_retired.clear();
+            return result;
+        }
+
+        /**
+            \brief Returns the number of retired segments that are not freed yet.
+            \return The number of retired segments.
+        */
+        size_t get_retired_count() const
+        {
+            return m_retired.size();
+        }
+
+        /**
+            \brief Hands the retired segments over, e.g. to free them on another thread.
+            \param[in,out] retired  Receives the retired segments, its capacity is used for segments retired afterwards.
+
+            Pass an empty vector, e.g. the one received before after destroying its segments, so no memory
+            is allocated. Segments that are still in it are destroyed first.
+        */
+        void take_retired(std::vector<segment_type>& retired)
+        {
+            retired.clear();
+            retired.swap(m_retired);
+            //retiring must not allocate until the number of segments is exceeded
+            reserve_retired();
+        }
+
+        /**
+            \brief Sets the handler that takes over evicted segments, an empty handler disables the handover.
+            \param[in] handler  The handler.
+        */
+        void set_handover_handler(handover_handler_type handler)
+        {
+            m_handover_handler = std::move(handler);
+        }
+
+        /**
+            \brief Hands the segment at the given index over to the handover handler.
+            \param[in] segment_index    The index of the segment, its items are not stored anymore.
+            \return True if the segment has been handed over, false if there is no handover handler.
+        */
+        bool hand_over(size_t segment_index)
+        {
+            if (!m_handover_handler)
+            {
+                return false;
+            }
+            m_handover_handler(m_segments[segment_index]);
+            assert(m_segments[segment_index].empty() || m_segments[segment_index].size() == get_segment_size());
+            return true;
+        }
+
+        /**
+            \brief Moves the items of an allocated segment to an unallocated segment.
+            \param[in] from_segment_index   The index of the allocated segment, it is unallocated afterwards.
+            \param[in] to_segment_index     The index of the unallocated segment.
+            \return True, segments can always be moved.
+        */
+        bool move(size_t from_segment_index, size_t to_segment_index)
+        {
+            assert(is_allocated(from_segment_index) && !is_allocated(to_segment_index));
+            m_segments[to_segment_index].swap(m_segments[from_segment_index]);
+            return true;
+        }
+
+        /**
+            \brief Returns the item at the given index, the segment of the item must be allocated.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The item at the given index.
+        */
+        value_type& get_item(size_t internal_index)
+        {
+            return m_segments[internal_index / get_segment_size()][internal_index % get_segment_size()];
+        }
+
+        /**
+            \brief Returns the item at the given index, the segment of the item must be allocated.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The item at the given index.
+        */
+        const value_type& get_item(size_t internal_index) const
+        {
+            return m_segments[internal_index / get_segment_size()][internal_index % get_segment_size()];
+        }
+
+        /**
+            \brief Returns the number of items stored contiguously in memory starting at the given index.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The number of items up to the end of the segment.
+        */
+        size_t get_contiguous_size(size_t internal_index) const
+        {
+            return get_segment_size() - internal_index % get_segment_size();
+        }
+
+        /**
+            \brief Destroyes all segments, including the retired ones, and configures the size parameters.
+            \param[in] number_of_segments    The number of segments.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \return True, any configuration can be applied.
+        */
+        bool configure(size_t number_of_segments, size_t segment_size)
+        {
+            m_segments.clear();
+            m_retired.clear();
+            m_max_size = 0;
+            m_segment_size = 0;
+            if (number_of_segments == 0 || segment_size == 0)
+            {
+                //nothing to do here; usable size will be zero
+            }
+            else
+            {
+                m_segment_size = segment_size;
+                m_segments.resize(number_of_segments, segment_type(m_allocator));
+                m_max_size = number_of_segments * segment_size;
+            }
+            return true;
+        }
+
+        /**
+            \brief Rotates the segments so first_segment becomes the first one and changes the number of segments.
+            \param[in] first_segment        The index of the segment that becomes the first segment.
+            \param[in] number_of_segments   The new number of segments, segments that do not fit anymore are freed.
+
+            Only the segments are moved, the items stay at their location in memory.
+        */
+        void relayout(size_t first_segment, size_t number_of_segments)
+        {
+            std::rotate(m_segments.begin(), m_segments.begin() + static_cast<std::ptrdiff_t>(first_segment), m_segments.end());
+            m_segments.resize(number_of_segments, segment_type(m_allocator));
+            m_max_size = number_of_segments * m_segment_size;
+        }
+
+    private:
+        std::vector<segment_type> m_segments;
+        std::vector<segment_type> m_retired;
+        size_t m_segment_size = 0;
+        size_t m_max_size = 0;
+        allocator_type m_allocator;
+        handover_handler_type m_handover_handler;
+    };
+
+    /**
+        \brief A segment table with a number of segments and a segment size known at compile time.
+
+        The geometry is constant, so the compiler can fold all index computations.
+        The table itself is stored inline without an additional allocation and holds
+        one pointer per segment, so an item is reached with a single indirection.
+    */
+    template <typename value_type, size_t static_segment_count, size_t static_segment_size>
+    class static_segment_table
+    {
+        static_assert(static_segment_count > 0 && static_segment_size > 0, "The segment count and the segment size must not be zero.");
+    public:
+        /**
+            \brief The type of a segment, a null segment is not allocated.
+        */
+        typedef std::unique_ptr<value_type[]> segment_type;
+
+        /**
+            \brief Returns the size of a segment.
+            \return The size of a segment.
+        */
+        static constexpr size_t get_segment_size()
+        {
+            return static_segment_size;
+        }
+
+        /**
+            \brief Returns the count of segments configured.
+            \return The count of segments configured.
+        */
+        static constexpr size_t get_segment_count()
+        {
+            return static_segment_count;
+        }
+
+        /**
+            \brief Returns the maximum number of items that can be stored.
+            \return The maximum number of items that can be stored.
+        */
+        static constexpr size_t get_max_size()
+        {
+            return static_segment_count * static_segment_size;
+        }
+
+        /**
+            \brief Returns true if the segment at the given index is allocated.
+            \param[in] segment_index    The index of the segment.
+            \return True if the segment at the given index is allocated.
+        */
+        bool is_allocated(size_t segment_index) const
+        {
+            return m_segments[segment_index] != nullptr;
+        }
+
+        /**
+            \brief Allocates the segment at the given index and constructs its items.
+            \param[in] segment_index    The index of the segment.
+        */
+        void allocate(size_t segment_index)
+        {
+            m_segments[segment_index].reset(new value_type[static_segment_size]());
+        }
+
+        /**
+            \brief Destroys the items of the segment at the given index and frees the memory.
+            \param[in] segment_index    The index of the segment.
+        */
+        void release(size_t segment_index)
+        {
+            m_segments[segment_index].reset();
+        }
+
+        /**
+            \brief Moves the segment at the given index to the retired segments without destroying its items.
+            \param[in] segment_index    The index of the segment, it is unallocated afterwards.
+
+            Retiring does not allocate, space is reserved by reserve_retired(). Retired segments are reused
+            by reuse_retired(), so the list does not grow beyond it. If it is full anyway, e.g. if no space
+            has been reserved, the segment is released immediately.
+        */
+        void retire(size_t segment_index)
+        {
+            if (m_retired.size() == m_retired.capacity())
+            {
+                release(segment_index);
+                return;
+            }
+            m_retired.push_back(std::move(m_segments[segment_index]));
+        }
+
+        /**
+            \brief Reserves space for one retired segment per segment, so retiring does not allocate.
+        */
+        void reserve_retired()
+        {
+            m_retired.reserve(get_segment_count());
+        }
+
+        /**
+            \brief Moves a retired segment to the unallocated segment at the given index, so it is not allocated again.
+            \param[in] segment_index    The index of the unallocated segment.
+            \return True if a retired segment has been reused, false if the segment must be allocated.
+
+            The items of a retired segment have been cleared by the ring buffer when they were removed.
+        */
+        bool reuse_retired(size_t segment_index)
+        {
+            if (m_retired.empty())
+            {
+                return false;
+            }
+            m_segments[segment_index] = std::move(m_retired.back());
+            m_retired.pop_back();
+            return true;
+        }
+
+        /**
+            \brief Destroys the items of the retired segments and frees their memory.
+            \return The number of segments freed.
+        */
+        size_t reclaim()
+        {
+            const size_t result = m_retired.size();
+            m_retired.clear();
+            return result;
+        }
+
+        /**
+            \brief Returns the number of retired segments that are not freed yet.
+            \return The number of retired segments.
+        */
+        size_t get_retired_count() const
+        {
+            return m_retired.size();
+        }
+
+        /**
+            \brief Hands the retired segments over, e.g. to free them on another thread.
+            \param[in,out] retired  Receives the retired segments, its capacity is used for segments retired afterwards.
+
+            Pass an empty vector, e.g. the one received before after destroying its segments, so no memory
+            is allocated. Segments that are still in it are destroyed first.
+        */
+        void take_retired(std::vector<segment_type>& retired)
+        {
+            retired.clear();
+            retired.swap(m_retired);
+            //retiring must not allocate until the number of segments is exceeded
+            reserve_retired();
+        }
+
+        /**
+            \brief Segments are not handed over.
+            \return False.
+        */
+        bool hand_over(size_t)
+        {
+            return false;
+        }
+
+        /**
+            \brief Moves the items of an allocated segment to an unallocated segment.
+            \param[in] from_segment_index   The index of the allocated segment, it is unallocated afterwards.
+            \param[in] to_segment_index     The index of the unallocated segment.
+            \return True, segments can always be moved.
+        */
+        bool move(size_t from_segment_index, size_t to_segment_index)
+        {
+            assert(is_allocated(from_segment_index) && !is_allocated(to_segment_index));
+            m_segments[to_segment_index] = std::move(m_segments[from_segment_index]);
+            return true;
+        }
+
+        /**
+            \brief Returns the item at the given index, the segment of the item must be allocated.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The item at the given index.
+        */
+        value_type& get_item(size_t internal_index)
+        {
+            return m_segments[internal_index / get_segment_size()][internal_index % get_segment_size()];
+        }
+
+        /**
+            \brief Returns the item at the given index, the segment of the item must be allocated.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The item at the given index.
+        */
+        const value_type& get_item(size_t internal_index) const
+        {
+            return m_segments[internal_index / get_segment_size()][internal_index % get_segment_size()];
+        }
+
+        /**
+            \brief Returns the number of items stored contiguously in memory starting at the given index.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The number of items up to the end of the segment.
+        */
+        size_t get_contiguous_size(size_t internal_index) const
+        {
+            return get_segment_size() - internal_index % get_segment_size();
+        }
+
+        /**
+            \brief Destroyes all segments, including the retired ones, and checks the size parameters.
+            \param[in] number_of_segments    The number of segments.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \return True if the size parameters match the static configuration.
+        */
+        bool configure(size_t number_of_segments, size_t segment_size)
+        {
+            for (size_t i = 0; i < static_segment_count; ++i)
+            {
+                release(i);
+            }
+            m_retired.clear();
+            return number_of_segments == static_segment_count && segment_size == static_segment_size;
+        }
+
+    private:
+        std::array<segment_type, static_segment_count> m_segments;
+        std::vector<segment_type> m_retired;
+    };
+
+    /**
+        \brief Counts segment allocations of a ring buffer.
+    */
+    struct allocation_statistics
+    {
+        /**
+            \brief The number of times a segment was allocated.
+        */
+        size_t allocated_segments = 0;
+
+        /**
+            \brief The number of times a segment was freed.
+        */
+        size_t released_segments = 0;
+
+        /**
+            \brief The number of segments currently allocated.
+        */
+        size_t used_segments = 0;
+
+        /**
+            \brief The maximum number of segments allocated at the same time.
+        */
+        size_t peak_used_segments = 0;
+
+        /**
+            \brief The number of times an unused segment was moved behind the end instead of being freed.
+        */
+        size_t recycled_segments = 0;
+    };
+
+    /**
+        \brief When a ring buffer frees segments that no longer hold items.
+    */
+    enum class release_mode
+    {
+        keep_spare, ///< Moves up to segment_release_policy::spare_segments unused segments behind the end, frees the others.
+        when_idle,  ///< Moves all unused segments behind the end, frees the ones not needed for segment_release_policy::idle_operations.
+        never       ///< Keeps all segments until clear() or release_unused_segments().
+    };
+
+    /**
+        \brief Configures when a ring buffer frees segments that no longer hold items.
+
+        A segment is unused when the front of the ring buffer moves past it. Instead of freeing it, it
+        can be moved behind the end of the stored items where it is reused by the next items added.
+        The segment adjacent to the front and the back is always kept.
+    */
+    struct segment_release_policy
+    {
+        /**
+            \brief The release mode.
+        */
+        release_mode mode = release_mode::keep_spare;
+
+        /**
+            \brief The number of spare segments kept behind the end with release_mode::keep_spare.
+        */
+        size_t spare_segments = 0;
+
+        /**
+            \brief The number of segment border crossings after which the segments that were
+                   not needed in between are freed with release_mode::when_idle.
+        */
+        size_t idle_operations = 64;
+    };
+
+    /**
+        \brief The way the items of a ring buffer are mostly read, used to recommend a geometry.
+    */
+    enum class access_pattern
+    {
+        sequential, ///< Items are mostly read in order, e.g. by scans or batch consumers.
+        random      ///< Items are mostly read by index at random positions.
+    };
+
+    /**
+        \brief Hints for recommended_geometry().
+    */
+    struct geometry_hints
+    {
+        /**
+            \brief The way the items are mostly read.
+        */
+        access_pattern pattern = access_pattern::sequential;
+
+        /**
+            \brief The size of a memory page, segments of whole pages are preferred.
+        */
+        size_t page_size = 4096;
+
+        /**
+            \brief The minimum number of segments, limits the memory allocated or freed at once.
+        */
+        size_t min_segments = 16;
+
+        /**
+            \brief The maximum number of segments, limits the size of the segment table.
+        */
+        size_t max_segments = 65536;
+    };
+
+    /**
+        \brief The number of segments and the segment size of a ring buffer.
+    */
+    struct geometry
+    {
+        /**
+            \brief The number of segments.
+        */
+        size_t number_of_segments;
+
+        /**
+            \brief The size of a segment in number of items stored.
+        */
+        size_t segment_size;
+    };
+
+    /**
+        \brief Limits the number of segments and rounds segments up to whole pages.
+        \param[in] capacity         The number of items to store.
+        \param[in] item_size        The size of an item in bytes.
+        \param[in] segment_size     The preferred size of a segment in number of items.
+        \param[in] hints            The hints.
+        \return The geometry, number_of_segments * segment_size is at least capacity.
+    */
+    inline geometry fit_geometry(size_t capacity, size_t item_size, size_t segment_size, const geometry_hints& hints)
+    {
+        geometry result = { 0, 0 };
+        if (capacity == 0 || item_size == 0)
+        {
+            return result;
+        }
+        segment_size = segment_size ? segment_size : 1;
+        if (hints.min_segments && capacity / segment_size < hints.min_segments)
+        {
+            segment_size = (capacity + hints.min_segments - 1) / hints.min_segments;
+        }
+        if (hints.max_segments && (capacity + segment_size - 1) / segment_size > hints.max_segments)
+        {
+            segment_size = (capacity + hints.max_segments - 1) / hints.max_segments;
+        }
+        if (hints.page_size && hints.page_size % item_size == 0 && segment_size * item_size >= hints.page_size)
+        {
+            const size_t items_per_page = hints.page_size / item_size;
+            segment_size = (segment_size + items_per_page - 1) / items_per_page * items_per_page;
+        }
+        result.segment_size = segment_size;
+        result.number_of_segments = (capacity + segment_size - 1) / segment_size;
+        return result;
+    }
+
+    /**
+        \brief Recommends a geometry for a ring buffer.
+        \param[in] capacity     The number of items to store.
+        \param[in] item_size    The size of an item in bytes, sizeof(value_type).
+        \param[in] hints        The hints.
+        \return The geometry, number_of_segments * segment_size is at least capacity.
+
+        Segments of 256 KiB are used for sequential access and 64 KiB for random access,
+        see doc/geometry.md for the benchmark the sizes are based on. The segment count is kept
+        between hints.min_segments and hints.max_segments.
+    */
+    inline geometry recommended_geometry(size_t capacity, size_t item_size, const geometry_hints& hints = geometry_hints())
+    {
+        const size_t segment_bytes = hints.pattern == access_pattern::sequential ? 256 * 1024 : 64 * 1024;
+        const size_t segment_size = item_size ? segment_bytes / item_size : 0;
+        return fit_geometry(capacity, item_size, segment_size, hints);
+    }
+
+    /**
+        \brief Recommends a geometry for a ring buffer based on the allocation statistics of its current geometry.
+        \param[in] current      The current geometry.
+        \param[in] item_size    The size of an item in bytes, sizeof(value_type).
+        \param[in] statistics   The allocation statistics collected with the current geometry.
+        \param[in] hints        The hints.
+        \return The geometry for the same capacity.
+
+        Segments that are freed and allocated again many times indicate that the number of stored
+        items varies by more than a segment, larger segments are recommended in this case. A ring
+        buffer that never uses more than hints.min_segments segments gets smaller segments, so
+        memory is allocated and freed in smaller steps. Apply it with discard_and_change_configuration()
+        or resize_segments() when convenient.
+    */
+    inline geometry recommended_geometry(const geometry& current, size_t item_size, const allocation_statistics& statistics, const geometry_hints& hints = geometry_hints())
+    {
+        const size_t capacity = current.number_of_segments * current.segment_size;
+        size_t segment_size = current.segment_size;
+        const size_t peak = statistics.peak_used_segments ? statistics.peak_used_segments : 1;
+        if (statistics.released_segments > 4 * peak)
+        {
+            segment_size *= 2;
+        }
+        else if (statistics.peak_used_segments < hints.min_segments && statistics.peak_used_segments < current.number_of_segments && segment_size > 1)
+        {
+            segment_size /= 2;
+        }
+        return fit_geometry(capacity, item_size, segment_size, hints);
+    }
+
+    /**
+        \brief A contiguous range of items inside a segment of a ring buffer.
+    */
+    template <typename item_type>
+    struct item_span
+    {
+        /**
+            \brief The first item of the range.
+        */
+        item_type* items;
+
+        /**
+            \brief The number of items in the range.
+        */
+        size_t count;
+
+        /**
+            \brief Returns the first item of the range.
+            \return The first item of the range.
+        */
+        item_type* begin() const
+        {
+            return items;
+        }
+
+        /**
+            \brief Returns the item past the last item of the range.
+            \return The item past the last item of the range.
+        */
+        item_type* end() const
+        {
+            return items + count;
+        }
+    };
+
+    /**
+        \brief A random access iterator over the items of a ring buffer.
+
+        The iterator caches the contiguous run of items it points into, so incrementing
+        within a segment is a pointer increment. When it moves to the next run it prefetches
+        the first cache lines of the run after it, and within a run it prefetches the item
+        get_prefetch_distance() items ahead.
+    */
+    template <typename ring_type, typename item_type>
+    class large_ring_buffer_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename std::remove_const<item_type>::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef item_type* pointer;
+        typedef item_type& reference;
+
+        /**
+            \brief Constructs an iterator that does not point to a ring buffer.
+        */
+        large_ring_buffer_iterator() = default;
+
+        /**
+            \brief Constructs an iterator.
+            \param[in] ring     The ring buffer.
+            \param[in] index    The index of the item in the ring buffer.
+        */
+        large_ring_buffer_iterator(const ring_type* ring, size_t index)
+            : m_ring(ring)
+            , m_index(index)
+        {
+        }
+
+        /**
+            \brief Converts an iterator to a const iterator.
+            \param[in] other    The iterator to convert.
+        */
+        template <typename other_item_type, typename = typename std::enable_if<std::is_convertible<other_item_type*, item_type*>::value>::type>
+        large_ring_buffer_iterator(const large_ring_buffer_iterator<ring_type, other_item_type>& other)
+            : m_ring(other.m_ring)
+            , m_index(other.m_index)
+        {
+        }
+
+        reference operator*() const
+        {
+            if (!m_run_remaining)
+            {
+                load_run();
+            }
+            return *m_item;
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type offset) const
+        {
+            return *(*this + offset);
+        }
+
+        large_ring_buffer_iterator& operator++()
+        {
+            ++m_index;
+            if (m_run_remaining > 1)
+            {
+                --m_run_remaining;
+                ++m_item;
+                if (m_prefetch_distance && m_prefetch_distance < m_run_remaining)
+                {
+                    prefetch(m_item + m_prefetch_distance);
+                }
+            }
+            else
+            {
+                m_run_remaining = 0;
+            }
+            return *this;
+        }
+
+        large_ring_buffer_iterator operator++(int)
+        {
+            large_ring_buffer_iterator result(*this);
+            ++*this;
+            return result;
+        }
+
+        large_ring_buffer_iterator& operator--()
+        {
+            return *this -= 1;
+        }
+
+        large_ring_buffer_iterator operator--(int)
+        {
+            large_ring_buffer_iterator result(*this);
+            --*this;
+            return result;
+        }
+
+        large_ring_buffer_iterator& operator+=(difference_type offset)
+        {
+            m_index += static_cast<size_t>(offset);
+            m_run_remaining = 0;
+            return *this;
+        }
+
+        large_ring_buffer_iterator& operator-=(difference_type offset)
+        {
+            return *this += -offset;
+        }
+
+        large_ring_buffer_iterator operator+(difference_type offset) const
+        {
+            large_ring_buffer_iterator result(m_ring, m_index);
+            return result += offset;
+        }
+
+        friend large_ring_buffer_iterator operator+(difference_type offset, const large_ring_buffer_iterator& iterator)
+        {
+            return iterator + offset;
+        }
+
+        large_ring_buffer_iterator operator-(difference_type offset) const
+        {
+            large_ring_buffer_iterator result(m_ring, m_index);
+            return result -= offset;
+        }
+
+        template <typename other_item_type>
+        difference_type operator-(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+        }
+
+        template <typename other_item_type>
+        bool operator==(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return m_index == other.m_index;
+        }
+
+        template <typename other_item_type>
+        bool operator!=(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return m_index != other.m_index;
+        }
+
+        template <typename other_item_type>
+        bool operator<(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return m_index < other.m_index;
+        }
+
+        template <typename other_item_type>
+        bool operator>(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return m_index > other.m_index;
+        }
+
+        template <typename other_item_type>
+        bool operator<=(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return m_index <= other.m_index;
+        }
+
+        template <typename other_item_type>
+        bool operator>=(const large_ring_buffer_iterator<ring_type, other_item_type>& other) const
+        {
+            return m_index >= other.m_index;
+        }
+
+    private:
+        template <typename, typename>
+        friend class large_ring_buffer_iterator;
+
+        void load_run() const
+        {
+            m_item = const_cast<item_type*>(m_ring->get_run(m_index, m_run_remaining));
+            m_prefetch_distance = m_ring->get_prefetch_distance();
+            m_ring->prefetch_run(m_index + m_run_remaining);
+        }
+
+        const ring_type* m_ring = nullptr;
+        size_t m_index = 0;
+        mutable item_type* m_item = nullptr;
+        mutable size_t m_run_remaining = 0;
+        mutable size_t m_prefetch_distance = 0;
+    };
+
+    /**
+        \brief A ring buffer implementation for a large number of items.
+
+         Implements a storage for a stream of n objects with index based access
+         that are updated continuously but shall not be moved in memory.
+         The segments and the geometry are provided by segment_table_type,
+         use large_ring_buffer or static_large_ring_buffer.
+    */
+    template <typename value_type, typename clear_handler_type, typename segment_table_type>
+    class basic_large_ring_buffer
+    {
+    public:
+        /**
+            \brief Handler that is called before items at the front of a full ring buffer are evicted.
+            \param[in] items    The first item that is going to be evicted.
+            \param[in] count    The number of contiguous items starting at items that are going to be evicted.
+        */
+        typedef std::function<void(const value_type* items, size_t count)> eviction_handler_type;
+
+        /**
+            \brief A random access iterator over the items from front to back.
+        */
+        typedef large_ring_buffer_iterator<basic_large_ring_buffer, value_type> iterator;
+
+        /**
+            \brief A random access iterator over the items from front to back.
+        */
+        typedef large_ring_buffer_iterator<basic_large_ring_buffer, const value_type> const_iterator;
+
+        /**
+            \brief Constructs a ring buffer object.
+        */
+        basic_large_ring_buffer() = default;
+
+        /**
+            \brief Destroys a ring buffer object.
+        */
+        ~basic_large_ring_buffer() = default;
+
+        /**
+            \brief Clears a ring buffer object.
+            \post
+            - The clear method has been called for items stored in the ring buffer.
+            - Segment buffers have been cleared. With deferred release they are only retired,
+              their memory is returned by reclaim() or take_retired_segments().
+        */
+        void clear()
+        {
+            release_front(size());
+
+            for (size_t i = 0; i < get_segment_count(); ++i)
+            {
+                release_segment(i);
+            }
+        }
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            size_t result = 0;
+            if (m_end_index == m_start_index)
+            {
+                if (m_full)
+                {
+                    result = get_max_size();
+                }
+                else
+                {
+                    result = 0;
+                }
+            }
+            else if (m_end_index >= m_start_index)
+            {
+                result = m_end_index - m_start_index;
+            }
+            else
+            {
+                result = (get_max_size() - m_start_index) + m_end_index;
+            }
+            return result;
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            return !m_full && m_end_index == m_start_index;
+        }
+
+        /**
+            \brief Returns true if the maximum configured number of items are currently stored in the ring buffer.
+            \return True if the maximum configured number of items are currently stored in the ring buffer.
+        */
+        bool full() const
+        {
+            return m_full;
+        }
+
+        /**
+            \brief Returns the maximum configured number of items that can be stored in the ring buffer.
+            \return The maximum configured number of items that can be stored in the ring buffer.
+        */
+        size_t get_max_size() const
+        {
+            return m_segments.get_max_size();
+        }
+
+        /**
+            \brief Returns the size of a segment.
+            \return The size of a segment.
+        */
+        size_t get_segment_size() const
+        {
+            return m_segments.get_segment_size();
+        }
+
+        /**
+            \brief Returns the count of segments configured.
+            \return The count of segments configured.
+        */
+        size_t get_segment_count() const
+        {
+            return m_segments.get_segment_count();
+        }
+
+        /**
+            \brief Returns the count of segments that are allocated.
+            \return The count of segments that are allocated.
+        */
+        size_t get_used_segments() const
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < get_segment_count(); ++i)
+            {
+                if (m_segments.is_allocated(i))
+                {
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        /**
+            \brief Returns the segment allocation statistics since the last configuration.
+            \return The segment allocation statistics.
+        */
+        allocation_statistics get_allocation_statistics() const
+        {
+            allocation_statistics statistics;
+            statistics.allocated_segments = m_allocated_segments;
+            statistics.released_segments = m_released_segments;
+            statistics.used_segments = get_allocated_count();
+            statistics.peak_used_segments = m_peak_used_segments;
+            statistics.recycled_segments = m_recycled_segments;
+            return statistics;
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        value_type& operator[](size_t index)
+        {
+            size_t internal_index = to_internal_index(index);
+            return get_stored_item(internal_index);
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        const value_type& operator[](size_t index) const
+        {
+            size_t internal_index = to_internal_index(index);
+            return get_item(internal_index);
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+            Throws an exception if the index is out of bounds.
+        */
+        value_type& at(size_t index)
+        {
+            if (index >= size())
+            {
+                throw std::range_error("Ringbuffer index out of bounds.");
+            }
+            size_t internal_index = to_internal_index(index);
+            return get_stored_item(internal_index);
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+            Throws an exception if the index is out of bounds.
+        */
+        const value_type& at(size_t index) const
+        {
+            if (index >= size())
+            {
+                throw std::range_error("Ringbuffer index out of bounds.");
+            }
+            size_t internal_index = to_internal_index(index);
+            return get_item(internal_index);
+        }
+
+        /**
+            \brief Returns an iterator to the item at the front.
+            \return An iterator to the item at the front.
+        */
+        iterator begin()
+        {
+            return iterator(this, 0);
+        }
+
+        /**
+            \brief Returns an iterator past the item at the back.
+            \return An iterator past the item at the back.
+        */
+        iterator end()
+        {
+            return iterator(this, size());
+        }
+
+        /**
+            \brief Returns an iterator to the item at the front.
+            \return An iterator to the item at the front.
+        */
+        const_iterator begin() const
+        {
+            return const_iterator(this, 0);
+        }
+
+        /**
+            \brief Returns an iterator past the item at the back.
+            \return An iterator past the item at the back.
+        */
+        const_iterator end() const
+        {
+            return const_iterator(this, size());
+        }
+
+        /**
+            \brief Returns an iterator to the item at the front.
+            \return An iterator to the item at the front.
+        */
+        const_iterator cbegin() const
+        {
+            return begin();
+        }
+
+        /**
+            \brief Returns an iterator past the item at the back.
+            \return An iterator past the item at the back.
+        */
+        const_iterator cend() const
+        {
+            return end();
+        }
+
+        /**
+            \brief Calls a function for each item from front to back.
+            \param[in] function     The function called with a reference to each item.
+
+            The items are visited one contiguous run at a time. While a run is processed the
+            first cache lines of the next run are prefetched, so the jump to the next segment
+            does not stall on a cache miss.
+        */
+        template <typename function_type>
+        void for_each(function_type function)
+        {
+            for_each(0, size(), function);
+        }
+
+        /**
+            \brief Calls a function for each item in a range.
+            \param[in] index        The index of the first item.
+            \param[in] count        The number of items, index + count must not be larger than size().
+            \param[in] function     The function called with a reference to each item.
+        */
+        template <typename function_type>
+        void for_each(size_t index, size_t count, function_type function)
+        {
+            assert(index + count <= size());
+            while (count)
+            {
+                size_t run = 0;
+                value_type* items = const_cast<value_type*>(get_run(index, run));
+                run = run < count ? run : count;
+                prefetch_run(index + run);
+                visit_run(items, run, function);
+                index += run;
+                count -= run;
+            }
+        }
+
+        /**
+            \brief Calls a function for each item from front to back.
+            \param[in] function     The function called with a const reference to each item.
+        */
+        template <typename function_type>
+        void for_each(function_type function) const
+        {
+            for_each(0, size(), function);
+        }
+
+        /**
+            \brief Calls a function for each item in a range.
+            \param[in] index        The index of the first item.
+            \param[in] count        The number of items, index + count must not be larger than size().
+            \param[in] function     The function called with a const reference to each item.
+        */
+        template <typename function_type>
+        void for_each(size_t index, size_t count, function_type function) const
+        {
+            assert(index + count <= size());
+            while (count)
+            {
+                size_t run = 0;
+                const value_type* items = get_run(index, run);
+                run = run < count ? run : count;
+                prefetch_run(index + run);
+                visit_run(items, run, function);
+                index += run;
+                count -= run;
+            }
+        }
+
+        /**
+            \brief Sets when segments that no longer hold items are freed.
+            \param[in] policy   The release policy.
+
+            The default frees a segment as soon as it is not adjacent to the stored items anymore.
+            Spare segments or a release after some idle operations avoid freeing and allocating
+            segments again and again when the number of stored items oscillates.
+        */
+        void set_segment_release_policy(const segment_release_policy& policy)
+        {
+            m_release_policy = policy;
+            m_idle_operations = 0;
+            m_idle_spare_segments = static_cast<size_t>(-1);
+        }
+
+        /**
+            \brief Returns when segments that no longer hold items are freed.
+            \return The release policy.
+        */
+        const segment_release_policy& get_segment_release_policy() const
+        {
+            return m_release_policy;
+        }
+
+        /**
+            \brief Defers destroying the items of segments that are not used anymore and freeing their memory.
+            \param[in] deferred     True to retire segments, false to free them immediately (default).
+
+            Retired segments are freed by reclaim(), so removing items takes a constant time,
+            independent of the segment size and the destructor of value_type. Segments that are needed
+            again reuse retired ones, so at most get_segment_count() segments are allocated or retired.
+            Call reclaim() periodically, e.g. when the consumer is idle, otherwise the memory of
+            segments the release policy freed is never returned.
+        */
+        void set_deferred_release(bool deferred)
+        {
+            m_deferred_release = deferred;
+            if (deferred)
+            {
+                m_segments.reserve_retired();
+            }
+        }
+
+        /**
+            \brief Returns true if freeing segments is deferred until reclaim() is called.
+            \return True if freeing segments is deferred.
+        */
+        bool is_deferred_release() const
+        {
+            return m_deferred_release;
+        }
+
+        /**
+            \brief Destroys the items of the retired segments and frees their memory.
+            \return The number of segments freed.
+        */
+        size_t reclaim()
+        {
+            return m_segments.reclaim();
+        }
+
+        /**
+            \brief Returns the number of retired segments waiting for reclaim().
+            \return The number of retired segments.
+        */
+        size_t get_retired_segments() const
+        {
+            return m_segments.get_retired_count();
+        }
+
+        /**
+            \brief Allocates all segments, so adding items does not allocate memory anymore.
+            \param[in] threads  The number of threads constructing the items of the segments.
+                                The allocator must be thread safe if more than one thread is used.
+
+            Constructing the items touches their memory, so it is backed by physical pages afterwards.
+            Use release_mode::never to keep the segments allocated, see also prefault().
+            Rethrows the first exception thrown while allocating a segment.
+        */
+        void reserve_all(size_t threads = 1)
+        {
+            std::vector<size_t> missing;
+            for (size_t i = 0; i < get_segment_count(); ++i)
+            {
+                if (!m_segments.is_allocated(i))
+                {
+                    if (m_segments.reuse_retired(i))
+                    {
+                        count_allocated_segment();
+                    }
+                    else
+                    {
+                        missing.push_back(i);
+                    }
+                }
+            }
+            if (threads > missing.size())
+            {
+                threads = missing.size();
+            }
+            if (threads <= 1)
+            {
+                for (size_t segment_index : missing)
+                {
+                    m_segments.allocate(segment_index);
+                    count_allocated_segment();
+                }
+                return;
+            }
+
+            //each thread allocates a contiguous block of segments, so first touch places them close to the thread
+            std::vector<unsigned char> allocated(missing.size());
+            std::vector<std::exception_ptr> errors(threads);
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([this, t, threads, &missing, &allocated, &errors]()
+                {
+                    try
+                    {
+                        const size_t last = missing.size() * (t + 1) / threads;
+                        for (size_t i = missing.size() * t / threads; i < last; ++i)
+                        {
+                            m_segments.allocate(missing[i]);
+                            allocated[i] = 1;
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+            for (unsigned char segment_allocated : allocated)
+            {
+                if (segment_allocated)
+                {
+                    count_allocated_segment();
+                }
+            }
+            for (const std::exception_ptr& error : errors)
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        /**
+            \brief Calls a function for each allocated segment, including segments that store no items.
+            \param[in] f    Called with a pointer to the first item of the segment and the segment size.
+        */
+        template <typename function_type>
+        void for_each_segment(function_type f)
+        {
+            for (size_t i = 0; i < get_segment_count(); ++i)
+            {
+                if (m_segments.is_allocated(i))
+                {
+                    f(&m_segments.get_item(i * get_segment_size()), get_segment_size());
+                }
+            }
+        }
+
+        /**
+            \brief Frees all segments that hold no items, regardless of the release policy.
+            \return The number of segments freed.
+        */
+        size_t release_unused_segments()
+        {
+            size_t released = 0;
+            const size_t segment_count = get_segment_count();
+            const size_t start_segment_index = segment_count ? m_start_index / get_segment_size() : 0;
+            const size_t spanned = get_spanned_segments();
+            for (size_t i = 0; i < segment_count; ++i)
+            {
+                //the segments holding items follow the start segment
+                const size_t distance = (i + segment_count - start_segment_index) % segment_count;
+                if (distance >= spanned && m_segments.is_allocated(i))
+                {
+                    release_segment(i);
+                    ++released;
+                }
+            }
+            return released;
+        }
+
+        /**
+            \brief Sets how many items ahead of the current item are prefetched within a contiguous run.
+            \param[in] distance     The distance in items, 0 disables the prefetch within runs (default).
+
+            Useful for large value types, where the hardware prefetcher does not run ahead far enough.
+            The first cache lines of the next run are always prefetched.
+        */
+        void set_prefetch_distance(size_t distance)
+        {
+            m_prefetch_distance = distance;
+        }
+
+        /**
+            \brief Returns how many items ahead of the current item are prefetched within a contiguous run.
+            \return The distance in items.
+        */
+        size_t get_prefetch_distance() const
+        {
+            return m_prefetch_distance;
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+                   Overwrites an item at the front if the ring buffer is full.
+            \return The last item in the ring buffer, delivers a cached value or a newly created one.
+        */
+        value_type& extend_back()
+        {
+            m_reserved_count = 0;
+            if (m_full && m_eviction_handler)
+            {
+                //frees the rest of the start segment
+                evict_front_run();
+            }
+            if (m_full)
+            {
                 value_type& item = get_item(m_start_index /*start will be overwritten*/);
                 clear_handler_type::clear(item);
                 increment_start_index();
@@ -380,147 +2049,726 @@ namespace cpplargeringbuffer
             }
             else
             {
-                increment_end_index();
-                value_type& item = get_item(before_end_index());
-                m_full = (m_start_index == m_end_index);
-                return item;
+                const size_t internal_index = m_end_index;
+                increment_end_index();
+                value_type& item = get_item(internal_index);
+                m_full = (m_start_index == m_end_index);
+                return item;
+            }
+        }
+
+        /**
+            \brief Adds an item at the front of the ring buffer.
+                   Overwrites an item at the back if the ring buffer is full.
+            \return The first item in the ring buffer, delivers a cached value or a newly created one.
+        */
+        value_type& extend_front()
+        {
+            m_reserved_count = 0;
+            if (m_full)
+            {
+                value_type& item = get_item(before_end_index() /*end will be overwritten*/);
+                clear_handler_type::clear(item);
+                decrement_start_index();
+                decrement_end_index();
+                return item;
+            }
+            else
+            {
+                decrement_start_index();
+                value_type& item = get_item(m_start_index);
+                m_full = (m_start_index == m_end_index);
+                return item;
+            }
+        }
+
+        /**
+            \brief Removes an item at the back of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_back()
+        {
+            assert(!empty());
+            m_reserved_count = 0;
+            clear_handler_type::clear(get_stored_item(before_end_index()));
+            decrement_end_index();
+            m_full = false;
+            if (is_end_at_start_of_segment()) //went to next segment
+            {
+                remove_unused_segments_back();
+            }
+        }
+
+        /**
+            \brief Removes an item at the front of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_front()
+        {
+            assert(!empty());
+            m_reserved_count = 0;
+            clear_handler_type::clear(get_stored_item(m_start_index));
+            increment_start_index();
+            m_full = false;
+            if (is_start_at_start_of_segment()) //went to next segment
+            {
+                remove_unused_segments_front();
+            }
+        }
+
+        /**
+            \brief Returns the item at the back of the ring buffer.
+            \return The item at the back of the ring buffer.
+        */
+        value_type& back()
+        {
+            assert(!empty());
+            value_type& result = get_stored_item(before_end_index());
+            return result;
+        }
+
+        /**
+            \brief Returns the item at the front of the ring buffer.
+            \return The item at the front of the ring buffer.
+        */
+        value_type& front()
+        {
+            assert(!empty());
+            value_type& result = get_stored_item(m_start_index);
+            return result;
+        }
+
+        /**
+            \brief Returns the item at the back of the ring buffer.
+            \return The item at the back of the ring buffer.
+        */
+        const value_type& back() const
+        {
+            assert(!empty());
+            const value_type& result = get_item(before_end_index());
+            return result;
+        }
+
+        /**
+            \brief Returns the item at the front of the ring buffer.
+            \return The item at the front of the ring buffer.
+        */
+        const value_type& front() const
+        {
+            assert(!empty());
+            const value_type& result = get_item(m_start_index);
+            return result;
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+                   Overwrites an item at the front if the ring buffer is full.
+            \param[in] item     The item to add.
+        */
+        void push_back(const value_type& item)
+        {
+            extend_back() = item;
+        }
+
+        /**
+            \brief Adds items at the back of the ring buffer.
+                   Overwrites items at the front if the ring buffer is full.
+            \param[in] items    The first item to add, must not be stored in the ring buffer.
+            \param[in] count    The number of items to add.
+
+            Same as calling push_back() for each item, but items are copied a segment at a time,
+            trivially copyable items with memcpy.
+        */
+        void push_back(const value_type* items, size_t count)
+        {
+            while (count && get_max_size())
+            {
+                const size_t reserved = reserve_back(count, span_writer(items));
+                commit_back(reserved);
+                count -= reserved;
+            }
+        }
+
+        /**
+            \brief Copies items from the front of the ring buffer without removing them.
+            \param[out] items   Receives the items.
+            \param[in] count    The maximum number of items, limited to size().
+            \return The number of items copied.
+
+            Items are copied a segment at a time, trivially copyable items with memcpy.
+        */
+        size_t copy_front(value_type* items, size_t count) const
+        {
+            count = count < size() ? count : size();
+            for (size_t index = 0; index < count;)
+            {
+                size_t run = 0;
+                const value_type* source = get_run(index, run);
+                run = run < count - index ? run : count - index;
+                copy_items(items + index, source, run);
+                index += run;
+            }
+            return count;
+        }
+
+        /**
+            \brief Adds an item at the front of the ring buffer.
+                   Overwrites an item at the back if the ring buffer is full.
+            \param[in] item     The item to add.
+        */
+        void push_front(const value_type& item)
+        {
+            extend_front() = item;
+        }
+
+        /**
+            \brief Reserves space for items at the back of the ring buffer to be written in place.
+            \param[in] count    The number of items to reserve, limited to get_max_size().
+            \param[out] spans   Receives one item_span<value_type> per contiguous range of reserved items.
+            \return The number of items reserved.
+
+            Items at the front that are going to be overwritten by the reserved items are removed
+            here, with an eviction handler a run up to the end of a segment at a time. The reserved items are cached
+            values like the ones delivered by extend_back(). They become part of the ring buffer
+            with commit_back(). Any other modification of the ring buffer discards the reservation,
+            the spans must not be written afterwards.
+        */
+        template <typename output_iterator>
+        size_t reserve_back(size_t count, output_iterator spans)
+        {
+            count = count < get_max_size() ? count : get_max_size();
+            size_t overwritten = size() + count > get_max_size() ? size() + count - get_max_size() : 0;
+            while (overwritten)
+            {
+                if (m_eviction_handler)
+                {
+                    const size_t run = evict_front_run();
+                    overwritten = run < overwritten ? overwritten - run : 0;
+                    continue;
+                }
+                const size_t run = get_contiguous_count(m_start_index, overwritten);
+                value_type* items = &get_stored_item(m_start_index);
+                clear_items<clear_handler_type>(items, run, 0);
+                m_start_index = (m_start_index + run == get_max_size()) ? 0 : m_start_index + run;
+                m_full = false;
+                overwritten -= run;
+            }
+
+            size_t internal_index = m_end_index;
+            size_t remaining = count;
+            while (remaining)
+            {
+                const size_t run = get_contiguous_count(internal_index, remaining);
+                const item_span<value_type> span = { &get_item(internal_index), run };
+                *spans++ = span;
+                internal_index = (internal_index + run == get_max_size()) ? 0 : internal_index + run;
+                remaining -= run;
+            }
+            m_reserved_count = count;
+            return count;
+        }
+
+        /**
+            \brief Adds reserved items at the back of the ring buffer.
+            \param[in] count    The number of items written, limited to the count returned by reserve_back().
+
+            Nothing is added if the reservation has been discarded by another modification.
+        */
+        void commit_back(size_t count)
+        {
+            count = count < m_reserved_count ? count : m_reserved_count;
+            assert(size() + count <= get_max_size());
+            if (count)
+            {
+                const bool full = (size() + count == get_max_size());
+                m_end_index += count;
+                if (m_end_index >= get_max_size())
+                {
+                    m_end_index -= get_max_size();
+                }
+                m_full = full;
+            }
+            m_reserved_count = 0;
+        }
+
+        /**
+            \brief Provides the items at the front of the ring buffer as contiguous spans without removing them.
+            \param[in] count    The maximum number of items, limited to size().
+            \param[out] spans   Receives one item_span<value_type> per contiguous range of items.
+            \return The number of items provided.
+
+            The spans stay valid until the items are removed, e.g. with release_front().
+        */
+        template <typename output_iterator>
+        size_t peek_front(size_t count, output_iterator spans)
+        {
+            count = count < size() ? count : size();
+            for (size_t index = 0; index < count;)
+            {
+                size_t run = 0;
+                value_type* items = const_cast<value_type*>(get_run(index, run));
+                run = run < count - index ? run : count - index;
+                const item_span<value_type> span = { items, run };
+                *spans++ = span;
+                index += run;
+            }
+            return count;
+        }
+
+        /**
+            \brief Provides the items at the front of the ring buffer as contiguous spans without removing them.
+            \param[in] count    The maximum number of items, limited to size().
+            \param[out] spans   Receives one item_span<const value_type> per contiguous range of items.
+            \return The number of items provided.
+        */
+        template <typename output_iterator>
+        size_t peek_front(size_t count, output_iterator spans) const
+        {
+            count = count < size() ? count : size();
+            for (size_t index = 0; index < count;)
+            {
+                size_t run = 0;
+                const value_type* items = get_run(index, run);
+                run = run < count - index ? run : count - index;
+                const item_span<const value_type> span = { items, run };
+                *spans++ = span;
+                index += run;
+            }
+            return count;
+        }
+
+        /**
+            \brief Removes items at the front of the ring buffer.
+            \param[in] count    The number of items to remove, must not be larger than size().
+
+            Same as calling pop_front() count times, but the start index is updated and unused
+            segments are freed once per segment instead of once per item.
+        */
+        void release_front(size_t count)
+        {
+            assert(count <= size());
+            //removing items might free segments behind the end
+            m_reserved_count = 0;
+            while (count)
+            {
+                const size_t run = get_contiguous_count(m_start_index, count);
+                value_type* items = &get_stored_item(m_start_index);
+                clear_items<clear_handler_type>(items, run, 0);
+                m_start_index = (m_start_index + run == get_max_size()) ? 0 : m_start_index + run;
+                m_full = false;
+                if (is_start_at_start_of_segment()) //went to next segment
+                {
+                    remove_unused_segments_front();
+                }
+                count -= run;
+            }
+        }
+
+        /**
+            \brief Removes the items at the front that are older than a cutoff.
+            \param[in] cutoff       Items with a timestamp less than cutoff are removed.
+            \param[in] projection   Returns the timestamp of an item, timestamps must be ascending from front to back.
+            \return The number of items removed.
+
+            Whole runs of items are removed after comparing only the last item of the run with the
+            cutoff. Only the run containing the first item to keep is searched, using a binary search.
+        */
+        template <typename time_type, typename projection_type>
+        size_t expire_front(const time_type& cutoff, projection_type projection)
+        {
+            size_t removed = 0;
+            while (!empty())
+            {
+                size_t run = 0;
+                const value_type* items = get_run(0, run);
+                if (projection(items[run - 1]) < cutoff)
+                {
+                    //the whole run is expired
+                    release_front(run);
+                    removed += run;
+                }
+                else
+                {
+                    const value_type* first_kept = std::partition_point(items, items + run, [&cutoff, &projection](const value_type& item)
+                    {
+                        return projection(item) < cutoff;
+                    });
+                    const size_t count = static_cast<size_t>(first_kept - items);
+                    release_front(count);
+                    removed += count;
+                    break;
+                }
+            }
+            return removed;
+        }
+
+        /**
+            \brief Writes the configuration and all stored items to a binary stream.
+            \param[in] stream   The stream to write to, should be opened in binary mode.
+
+            Only available for trivially copyable value types. The items are written
+            with one write per contiguous run of memory, no per item serialization is done.
+            The data is written in native byte order and can only be loaded on the same platform.
+            Throws an exception if writing to the stream fails.
+        */
+        void save(std::ostream& stream) const
+        {
+            static_assert(std::is_trivially_copyable<value_type>::value, "save() requires a trivially copyable value_type.");
+            const size_t item_count = size();
+            const std::uint64_t header[] =
+            {
+                snapshot_magic,
+                snapshot_version,
+                sizeof(value_type),
+                get_segment_count(),
+                get_segment_size(),
+                item_count
+            };
+            stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+            size_t internal_index = m_start_index;
+            size_t remaining = item_count;
+            while (remaining && stream)
+            {
+                const size_t contiguous = m_segments.get_contiguous_size(internal_index);
+                const size_t run = remaining < contiguous ? remaining : contiguous;
+                prefetch_run(item_count - remaining + run);
+                stream.write(reinterpret_cast<const char*>(&get_item(internal_index)), static_cast<std::streamsize>(run * sizeof(value_type)));
+                internal_index = (internal_index + run == get_max_size()) ? 0 : internal_index + run;
+                remaining -= run;
+            }
+
+            if (!stream)
+            {
+                throw std::runtime_error("Ringbuffer snapshot could not be written.");
+            }
+        }
+
+        /**
+            \brief Destroyes all stored objects and restores configuration and items from a binary stream.
+            \param[in] stream   The stream to read from, should be opened in binary mode.
+
+            Only available for trivially copyable value types. The stream must contain data written by save().
+            Items are read directly into freshly allocated segments, one read per segment.
+            Throws an exception if the stream does not contain a valid snapshot or its geometry cannot be addressed;
+            the ring buffer is empty in this case.
+            \post
+            - All items stored before are destroyed.
+            - Clear is not called on the items.
+            - The configuration and the items of the snapshot are applied.
+        */
+        void load(std::istream& stream)
+        {
+            static_assert(std::is_trivially_copyable<value_type>::value, "load() requires a trivially copyable value_type.");
+            std::uint64_t header[6] = {};
+            stream.read(reinterpret_cast<char*>(header), sizeof(header));
+            if (!stream || header[0] != snapshot_magic || header[1] != snapshot_version || header[2] != sizeof(value_type))
+            {
+                discard_and_configure(0, 0);
+                throw std::runtime_error("Ringbuffer snapshot header is invalid.");
+            }
+
+            //the geometry must be addressable before anything is configured
+            const std::uint64_t max_items = std::numeric_limits<size_t>::max() / sizeof(value_type);
+            if (header[3] > max_items || header[4] > max_items || (header[3] != 0 && header[4] > max_items / header[3]))
+            {
+                discard_and_configure(0, 0);
+                throw std::runtime_error("Ringbuffer snapshot geometry is too large.");
+            }
+
+            const size_t number_of_segments = static_cast<size_t>(header[3]);
+            const size_t segment_size = static_cast<size_t>(header[4]);
+            const size_t item_count = static_cast<size_t>(header[5]);
+            if (header[5] > header[3] * header[4])
+            {
+                discard_and_configure(0, 0);
+                throw std::runtime_error("Ringbuffer snapshot header is invalid.");
+            }
+
+            if (!discard_and_configure(number_of_segments, segment_size))
+            {
+                discard_and_configure(0, 0);
+                throw std::runtime_error("Ringbuffer snapshot does not match the configuration.");
+            }
+            size_t internal_index = 0;
+            while (internal_index < item_count)
+            {
+                const size_t run = get_contiguous_count(internal_index, item_count - internal_index);
+                stream.read(reinterpret_cast<char*>(&get_item(internal_index)), static_cast<std::streamsize>(run * sizeof(value_type)));
+                if (!stream)
+                {
+                    discard_and_configure(0, 0);
+                    throw std::runtime_error("Ringbuffer snapshot is truncated.");
+                }
+                internal_index += run;
+            }
+            m_end_index = (item_count == get_max_size()) ? 0 : item_count;
+            m_full = (item_count != 0 && item_count == get_max_size());
+        }
+
+        /**
+            \brief Sets a handler that is called before extend_back() or reserve_back() evicts items at the front of a full ring buffer.
+            \param[in] handler  The handler to call, an empty handler disables the notification.
+
+            With a handler, a full ring buffer evicts the contiguous run of items from the front up to
+            the end of its segment at once, usually a complete segment, so it holds up to segment_size - 1
+            items less than get_max_size() afterwards. The handler receives each run before its items are
+            removed and can be used to persist items before they are lost, e.g. using a segment_spiller.
+            Complete segments are not reported if the segment table hands them over instead, see
+            large_ring_buffer::set_segment_handover_handler().
+            Throwing from the handler leaves the ring buffer unchanged.
+        */
+        void set_eviction_handler(eviction_handler_type handler)
+        {
+            m_eviction_handler = std::move(handler);
+        }
+
+    protected:
+        /**
+            \brief Destroyes all stored objects and configures the size parameters.
+            \param[in] number_of_segments    The number of segments.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \return True if the segment table supports the configuration.
+        */
+        bool discard_and_configure(size_t number_of_segments, size_t segment_size)
+        {
+            m_start_index = 0;
+            m_end_index = 0;
+            m_full = false;
+            m_reserved_count = 0;
+            m_released_segments = 0;
+            m_recycled_segments = 0;
+            m_allocated_segments = 0;
+            m_peak_used_segments = 0;
+            m_idle_operations = 0;
+            m_idle_spare_segments = static_cast<size_t>(-1);
+            const bool result = m_segments.configure(number_of_segments, segment_size);
+            if (m_deferred_release)
+            {
+                m_segments.reserve_retired();
+            }
+            return result;
+        }
+
+        /**
+            \brief Changes the number of segments and keeps the stored items.
+            \param[in] number_of_segments   The new number of segments, must not be zero.
+
+            The segment table is rotated so the segment of the front item becomes the first segment.
+            Items stay at their location in memory, only up to segment_size items that wrap around
+            the end of the new layout are moved. If there are more items than the new capacity, the
+            oldest items are removed. The segment table must support relayout().
+        */
+        void relayout_segments(size_t number_of_segments)
+        {
+            if (number_of_segments == 0 || get_segment_size() == 0)
+            {
+                throw std::range_error("Ringbuffer segments cannot be resized to zero or if not configured.");
+            }
+            const size_t old_segment_count = get_segment_count();
+            if (number_of_segments == old_segment_count)
+            {
+                return;
+            }
+            const size_t segment_size = get_segment_size();
+            const size_t new_max_size = number_of_segments * segment_size;
+            if (size() > new_max_size)
+            {
+                release_front(size() - new_max_size);
+            }
+            const size_t old_max_size = get_max_size();
+            const size_t start_segment = m_start_index / segment_size;
+            const size_t start_offset = m_start_index % segment_size;
+            const size_t item_count = size();
+
+            if (start_offset + item_count > new_max_size && new_max_size < old_max_size)
+            {
+                //the back items do not fit behind the front anymore, move them in front of the start in the start segment
+                for (size_t i = new_max_size - start_offset; i < item_count; ++i)
+                {
+                    get_stored_item(start_segment * segment_size + start_offset + i - new_max_size) = std::move(get_stored_item(to_internal_index(i)));
+                }
+            }
+            m_segments.relayout(start_segment, number_of_segments);
+            if (m_deferred_release)
+            {
+                m_segments.reserve_retired();
+            }
+            m_start_index = start_offset;
+            if (start_offset + item_count > old_max_size && new_max_size > old_max_size)
+            {
+                //the back items are stored in front of the start in the same segment, move them to the next segment
+                const size_t wrapped_count = start_offset + item_count - old_max_size;
+                for (size_t i = 0; i < wrapped_count; ++i)
+                {
+                    get_item(old_max_size + i) = std::move(get_stored_item(i));
+                }
+            }
+            m_end_index = (start_offset + item_count) % get_max_size();
+            m_full = item_count != 0 && item_count == get_max_size();
+            m_reserved_count = 0;
+            //segments beyond the new count have been freed by the segment table
+            m_released_segments = m_allocated_segments - get_used_segments();
+        }
+
+        /**
+            \brief Returns the segment table.
+            \return The segment table.
+        */
+        segment_table_type& get_segment_table()
+        {
+            return m_segments;
+        }
+
+        /**
+            \brief Returns the segment table.
+            \return The segment table.
+        */
+        const segment_table_type& get_segment_table() const
+        {
+            return m_segments;
+        }
+
+    private:
+        template <typename, typename>
+        friend class large_ring_buffer_iterator;
+
+        static const std::uint64_t snapshot_magic = 0x4246524C50504323ull; // "#CPPLRFB"
+        static const std::uint64_t snapshot_version = 1;
+        static const size_t prefetch_cache_lines = 4;
+
+        // returns the stored items from index up to the end of the contiguous memory
+        const value_type* get_run(size_t index, size_t& count) const
+        {
+            assert(index < size());
+            const size_t internal_index = to_internal_index(index);
+            const size_t contiguous = m_segments.get_contiguous_size(internal_index);
+            const size_t remaining = size() - index;
+            count = remaining < contiguous ? remaining : contiguous;
+            return &get_item(internal_index);
+        }
+
+        // removes the stored items from the front up to the end of its segment, they are handed over with the segment or reported to the eviction handler
+        size_t evict_front_run()
+        {
+            const size_t count = get_contiguous_count(m_start_index, size());
+            const size_t segment_index = m_start_index / get_segment_size();
+            if (count == get_segment_size() && m_segments.hand_over(segment_index))
+            {
+                //the segment has been replaced by an unallocated one or by a segment whose items are not stored
+                if (m_segments.is_allocated(segment_index))
+                {
+                    clear_items<clear_handler_type>(&m_segments.get_item(m_start_index), count, 0);
+                }
+                else
+                {
+                    ++m_released_segments;
+                }
+            }
+            else
+            {
+                value_type* items = &get_stored_item(m_start_index);
+                m_eviction_handler(items, count);
+                clear_items<clear_handler_type>(items, count, 0);
             }
+            m_start_index = (m_start_index + count == get_max_size()) ? 0 : m_start_index + count;
+            m_full = false;
+            return count;
         }
 
-        /**
-            \brief Adds an item at the front of the ring buffer.
-                   Overwrites an item at the back if the ring buffer is full.
-            \return The first item in the ring buffer, delivers a cached value or a newly created one.
-        */
-        value_type& extend_front()
+        // an output iterator for reserve_back() that copies the next items into each span, copies share the position
+        class span_writer
         {
-            if (m_full)
+        public:
+            explicit span_writer(const value_type*& items) : m_items(&items)
             {
-                value_type& item = get_item(before_end_index() /*end will be overwritten*/);
-                clear_handler_type::clear(item);
-                decrement_start_index();
-                decrement_end_index();
-                return item;
             }
-            else
+
+            span_writer& operator*()
             {
-                decrement_start_index();
-                value_type& item = get_item(m_start_index);
-                m_full = (m_start_index == m_end_index);
-                return item;
+                return *this;
             }
-        }
 
-        /**
-            \brief Removes an item at the back of the ring buffer.
-            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
-        */
-        void pop_back()
-        {
-            assert(!empty());
-            clear_handler_type::clear(get_item(before_end_index()));
-            decrement_end_index();
-            m_full = false;
-            if (is_end_at_start_of_segment()) //went to next segment
+            span_writer& operator++()
             {
-                remove_unused_segments_back();
+                return *this;
             }
-        }
 
-        /**
-            \brief Removes an item at the front of the ring buffer.
-            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
-        */
-        void pop_front()
-        {
-            assert(!empty());
-            clear_handler_type::clear(get_item(m_start_index));
-            increment_start_index();
-            m_full = false;
-            if (is_start_at_start_of_segment()) //went to next segment
+            span_writer operator++(int)
             {
-                remove_unused_segments_front();
+                return *this;
             }
-        }
 
-        /**
-            \brief Returns the item at the back of the ring buffer.
-            \return The item at the back of the ring buffer.
-        */
-        value_type& back()
-        {
-            assert(!empty());
-            value_type& result = get_item(before_end_index());
-            return result;
-        }
+            span_writer& operator=(const item_span<value_type>& span)
+            {
+                copy_items(span.items, *m_items, span.count);
+                *m_items += span.count;
+                return *this;
+            }
 
-        /**
-            \brief Returns the item at the front of the ring buffer.
-            \return The item at the front of the ring buffer.
-        */
-        value_type& front()
-        {
-            assert(!empty());
-            value_type& result = get_item(m_start_index);
-            return result;
-        }
+        private:
+            const value_type** m_items;
+        };
 
-        /**
-            \brief Returns the item at the back of the ring buffer.
-            \return The item at the back of the ring buffer.
-        */
-        const value_type& back() const
+        // the number of segments between the start segment and the end of the stored items
+        size_t get_spanned_segments() const
         {
-            assert(!empty());
-            value_type& result = get_item(before_end_index());
+            return empty() ? 0 : (m_start_index % get_segment_size() + size() + get_segment_size() - 1) / get_segment_size();
         }
 
-        /**
-            \brief Returns the item at the front of the ring buffer.
-            \return The item at the front of the ring buffer.
-        */
-        const value_type& front() const
+        // prefetches the first cache lines of the run starting at index
+        void prefetch_run(size_t index) const
         {
-            assert(!empty());
-            value_type& result = get_item(m_start_index);
+            if (index < size())
+            {
+                const char* items = reinterpret_cast<const char*>(&get_item(to_internal_index(index)));
+                for (size_t i = 0; i < prefetch_cache_lines; ++i)
+                {
+                    prefetch(items + i * cache_line_size);
+                }
+            }
         }
 
-        /**
-            \brief Adds an item at the back of the ring buffer.
-                   Overwrites an item at the front if the ring buffer is full.
-            \param[in] item     The item to add.
-        */
-        void push_back(const value_type& item)
+        template <typename item_type, typename function_type>
+        void visit_run(item_type* items, size_t count, function_type& function) const
         {
-            extend_back() = item;
+            size_t i = 0;
+            if (m_prefetch_distance && count > m_prefetch_distance)
+            {
+                for (; i < count - m_prefetch_distance; ++i)
+                {
+                    prefetch(items + i + m_prefetch_distance);
+                    function(items[i]);
+                }
+            }
+            for (; i < count; ++i)
+            {
+                function(items[i]);
+            }
         }
 
-        /**
-            \brief Adds an item at the front of the ring buffer.
-                   Overwrites an item at the back if the ring buffer is full.
-            \param[in] item     The item to add.
-        */
-        void push_front(const value_type& item)
+        size_t get_contiguous_count(size_t internal_index, size_t count) const
         {
-            extend_front() = item;
+            //items are contiguous up to the end of the segment
+            const size_t segment_remaining = get_segment_size() - (internal_index % get_segment_size());
+            return count < segment_remaining ? count : segment_remaining;
         }
 
-    private:
         size_t to_internal_index(size_t index) const
         {
             size_t internal_index = m_start_index + index;
-            if (internal_index >= m_max_size)
+            if (internal_index >= get_max_size())
             {
-                internal_index -= m_max_size;
+                internal_index -= get_max_size();
             }
             return internal_index;
         }
 
         void increment_start_index()
         {
-            assert(m_max_size);
+            assert(get_max_size());
             ++m_start_index;
-            if (m_start_index == m_max_size)
+            if (m_start_index == get_max_size())
             {
                 m_start_index = 0;
             }
@@ -530,8 +2778,8 @@ namespace cpplargeringbuffer
         {
             if (m_start_index == 0)
             {
-                assert(m_max_size);
-                m_start_index = m_max_size - 1;
+                assert(get_max_size());
+                m_start_index = get_max_size() - 1;
             }
             else
             {
@@ -541,9 +2789,9 @@ namespace cpplargeringbuffer
 
         void increment_end_index()
         {
-            assert(m_max_size);
+            assert(get_max_size());
             ++m_end_index;
-            if (m_end_index == m_max_size)
+            if (m_end_index == get_max_size())
             {
                 m_end_index = 0;
             }
@@ -553,7 +2801,7 @@ namespace cpplargeringbuffer
         {
             if (m_end_index == 0)
             {
-                m_end_index = m_max_size - 1;
+                m_end_index = get_max_size() - 1;
             }
             else
             {
@@ -566,21 +2814,21 @@ namespace cpplargeringbuffer
             size_t result = m_end_index - 1;
             if (m_end_index == 0)
             {
-                assert(m_max_size);
-                result = m_max_size - 1;
+                assert(get_max_size());
+                result = get_max_size() - 1;
             }
             return result;
         }
 
         bool is_end_at_start_of_segment() const
         {
-            bool result = (m_end_index % m_segment_size == 0);
+            bool result = (m_end_index % get_segment_size() == 0);
             return result;
         }
 
         bool is_start_at_start_of_segment() const
         {
-            bool result = (m_start_index % m_segment_size == 0);
+            bool result = (m_start_index % get_segment_size() == 0);
             return result;
         }
 
@@ -607,31 +2855,38 @@ namespace cpplargeringbuffer
 
         bool can_remove_segments()
         {
-            size_t count_unused = m_max_size - size();
-            bool result = count_unused > m_segment_size;
+            size_t count_unused = get_max_size() - size();
+            bool result = count_unused > get_segment_size();
             return result;
         }
 
         void remove_unused_segments_front()
         {
-            if (can_remove_segments())
+            if (can_remove_segments() && m_release_policy.mode != release_mode::never)
             {
-                size_t segment_index = m_start_index / m_segment_size;
-                size_t end_segment_index = m_end_index / m_segment_size;
-                const size_t segment_count = m_max_size / m_segment_size;
+                size_t segment_index = m_start_index / get_segment_size();
+                size_t end_segment_index = m_end_index / get_segment_size();
+                const size_t segment_count = get_max_size() / get_segment_size();
 
                 //keep the segment adjacent to start, to avoid reallocations when index jitters just by one around segment border
                 decrement_segment_start(segment_index, segment_count);
-                if (segment_index != end_segment_index && !m_segments[segment_index].empty())
+                if (segment_index != end_segment_index && m_segments.is_allocated(segment_index))
                 {
                     decrement_segment_start(segment_index, segment_count);
-                    auto& segment = m_segments[segment_index];
-                    while (segment_index != end_segment_index && !segment.empty())
+                    if (segment_index != end_segment_index)
                     {
-                        //completely remove the segment and free the memory
-                        segment.clear();
-                        std::vector<value_type> temp;
-                        segment.swap(temp);
+                        if (m_release_policy.mode == release_mode::keep_spare)
+                        {
+                            if (!recycle_segment(segment_index, m_release_policy.spare_segments))
+                            {
+                                release_segment(segment_index);
+                            }
+                        }
+                        else
+                        {
+                            recycle_segment(segment_index, segment_count);
+                            count_idle_operation();
+                        }
                     }
                 }
             }
@@ -639,24 +2894,105 @@ namespace cpplargeringbuffer
 
         void remove_unused_segments_back()
         {
-            if (can_remove_segments())
+            if (can_remove_segments() && m_release_policy.mode != release_mode::never)
             {
-                size_t segment_index = m_end_index / m_segment_size;
-                size_t start_segment_index = m_start_index / m_segment_size;
-                const size_t segment_count = m_max_size / m_segment_size;
+                size_t segment_index = m_end_index / get_segment_size();
+                size_t start_segment_index = m_start_index / get_segment_size();
+                const size_t segment_count = get_max_size() / get_segment_size();
+
+                if (m_release_policy.mode == release_mode::when_idle)
+                {
+                    count_idle_operation();
+                    return;
+                }
 
                 //keep the segment adjacent to start, to avoid reallocations when index jitters just by one around segment border
                 increment_segment_end(segment_index, segment_count);
-                if (segment_index != start_segment_index && !m_segments[segment_index].empty())
+                if (segment_index != start_segment_index && m_segments.is_allocated(segment_index))
+                {
+                    //keep the spare segments for the next items
+                    for (size_t i = 0; i <= m_release_policy.spare_segments; ++i)
+                    {
+                        increment_segment_end(segment_index, segment_count);
+                        if (segment_index == start_segment_index)
+                        {
+                            return;
+                        }
+                    }
+                    release_segment(segment_index);
+                }
+            }
+        }
+
+        // moves an unused segment to the first unallocated one of the spare_segments after the end segment,
+        // returns true if the segment is kept
+        bool recycle_segment(size_t segment_index, size_t spare_segments)
+        {
+            if (!m_segments.is_allocated(segment_index))
+            {
+                return false;
+            }
+            size_t spare_index = m_end_index / get_segment_size();
+            const size_t segment_count = get_max_size() / get_segment_size();
+            for (size_t i = 0; i < spare_segments; ++i)
+            {
+                increment_segment_end(spare_index, segment_count);
+                if (spare_index == segment_index)
+                {
+                    //already one of the spare segments
+                    return true;
+                }
+                if (!m_segments.is_allocated(spare_index))
+                {
+                    if (m_segments.move(segment_index, spare_index))
+                    {
+                        ++m_recycled_segments;
+                        return true;
+                    }
+                    //the segment table cannot move segments, keep it in place unless spare segments are limited
+                    return spare_segments == segment_count;
+                }
+            }
+            return false;
+        }
+
+        // frees the spare segments that were not needed during the last idle_operations segment border crossings
+        void count_idle_operation()
+        {
+            const size_t spanned = get_spanned_segments();
+            const size_t spare = get_allocated_count() > spanned ? get_allocated_count() - spanned : 0;
+            if (spare < m_idle_spare_segments)
+            {
+                m_idle_spare_segments = spare;
+            }
+            if (++m_idle_operations >= m_release_policy.idle_operations)
+            {
+                release_spare_segments(m_idle_spare_segments);
+                m_idle_operations = 0;
+                m_idle_spare_segments = static_cast<size_t>(-1);
+            }
+        }
+
+        // frees up to limit unused segments, the ones farthest from the end segment first
+        void release_spare_segments(size_t limit)
+        {
+            if (can_remove_segments())
+            {
+                size_t segment_index = m_start_index / get_segment_size();
+                const size_t end_segment_index = m_end_index / get_segment_size();
+                const size_t segment_count = get_max_size() / get_segment_size();
+                size_t released = 0;
+                while (released < limit)
                 {
-                    increment_segment_end(segment_index, segment_count);
-                    auto& segment = m_segments[segment_index];
-                    while (segment_index != start_segment_index && !segment.empty())
+                    decrement_segment_start(segment_index, segment_count);
+                    if (segment_index == end_segment_index)
+                    {
+                        break;
+                    }
+                    if (m_segments.is_allocated(segment_index))
                     {
-                        //completely remove the segment and free the memory
-                        segment.clear();
-                        std::vector<value_type> temp;
-                        segment.swap(temp);
+                        release_segment(segment_index);
+                        ++released;
                     }
                 }
             }
@@ -664,29 +3000,210 @@ namespace cpplargeringbuffer
 
         const value_type& get_item(size_t internal_index) const
         {
-            size_t segment_index = internal_index / m_segment_size;
-            size_t item_index = internal_index % m_segment_size;
-            return m_segments[segment_index][item_index];
+            assert(m_segments.is_allocated(internal_index / get_segment_size()));
+            return m_segments.get_item(internal_index);
+        }
+
+        value_type& get_stored_item(size_t internal_index)
+        {
+            //items in the ring buffer are always in allocated segments
+            assert(m_segments.is_allocated(internal_index / get_segment_size()));
+            return m_segments.get_item(internal_index);
         }
 
         value_type& get_item(size_t internal_index)
         {
-            size_t segment_index = internal_index / m_segment_size;
-            size_t item_index = internal_index % m_segment_size;
             //create segment if needed
-            auto& segment = m_segments[segment_index];
-            if (segment.empty())
+            const size_t segment_index = internal_index / get_segment_size();
+            if (!m_segments.is_allocated(segment_index))
+            {
+                if (!m_segments.reuse_retired(segment_index))
+                {
+                    m_segments.allocate(segment_index);
+                }
+                count_allocated_segment();
+            }
+            return m_segments.get_item(internal_index);
+        }
+
+        // the number of segments currently allocated
+        size_t get_allocated_count() const
+        {
+            return m_allocated_segments - m_released_segments;
+        }
+
+        void count_allocated_segment()
+        {
+            //all spare segments are in use
+            m_idle_spare_segments = 0;
+            ++m_allocated_segments;
+            if (get_allocated_count() > m_peak_used_segments)
+            {
+                m_peak_used_segments = get_allocated_count();
+            }
+        }
+
+        void release_segment(size_t segment_index)
+        {
+            if (m_segments.is_allocated(segment_index))
             {
-                segment.resize(m_segment_size);
+                if (m_deferred_release)
+                {
+                    m_segments.retire(segment_index);
+                }
+                else
+                {
+                    m_segments.release(segment_index);
+                }
+                ++m_released_segments;
             }
-            return m_segments[segment_index][item_index];
         }
 
-        std::vector< std::vector<value_type> > m_segments;
+        segment_table_type m_segments;
+        eviction_handler_type m_eviction_handler;
+        size_t m_prefetch_distance = 0;
+        segment_release_policy m_release_policy;
+        bool m_deferred_release = false;
         size_t m_start_index = 0;
         size_t m_end_index = 0;
         bool m_full = false; // if m_start_index == m_end_index indicates either full or empty that's why we need this flag
-        size_t m_segment_size = 0;
-        size_t m_max_size = 0;
+        size_t m_reserved_count = 0;
+        size_t m_allocated_segments = 0;
+        size_t m_released_segments = 0;
+        size_t m_peak_used_segments = 0;
+        size_t m_recycled_segments = 0;
+        size_t m_idle_operations = 0;
+        size_t m_idle_spare_segments = static_cast<size_t>(-1);
+    };
+
+    /**
+        \brief A ring buffer implementation for a large number of items.
+
+         Implements a storage for a stream of n objects with index based access
+         that are updated continuously but shall not be moved in memory.
+         The geometry is configured at runtime. The memory of the segments is obtained from allocator_type.
+    */
+    template <typename value_type, typename clear_handler_type = noop_clear_handler<value_type>, typename allocator_type = std::allocator<value_type> >
+    class large_ring_buffer : public basic_large_ring_buffer<value_type, clear_handler_type, dynamic_segment_table<value_type, allocator_type> >
+    {
+    public:
+        /**
+            \brief The type of a segment, an empty segment is not allocated.
+        */
+        typedef typename dynamic_segment_table<value_type, allocator_type>::segment_type segment_type;
+
+        /**
+            \brief Handler that takes over a segment whose items are evicted from a full ring buffer.
+        */
+        typedef typename dynamic_segment_table<value_type, allocator_type>::handover_handler_type handover_handler_type;
+
+        /**
+            \brief Constructs a ring buffer object.
+        */
+        large_ring_buffer() = default;
+
+        /**
+            \brief Constructs a ring buffer object and configures it's size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+                                             All items are constructed and destroyed at the same time when needed.
+
+            number_of_segments * segment_size can be used to compute the number of items that can be stored.
+        */
+        large_ring_buffer(size_t number_of_segments, size_t segment_size)
+        {
+            discard_and_change_configuration(number_of_segments, segment_size);
+        }
+
+        /**
+            \brief Constructs a ring buffer object that allocates its segments with the given allocator.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] allocator             The allocator used for the memory of the segments.
+        */
+        large_ring_buffer(size_t number_of_segments, size_t segment_size, const allocator_type& allocator)
+        {
+            this->get_segment_table().set_allocator(allocator);
+            discard_and_change_configuration(number_of_segments, segment_size);
+        }
+
+        /**
+            \brief Returns the allocator used for the memory of the segments.
+            \return The allocator used for the memory of the segments.
+        */
+        const allocator_type& get_allocator() const
+        {
+            return this->get_segment_table().get_allocator();
+        }
+
+        /**
+            \brief Destroyes all stored objects and configures the size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+                                             All items are constructed and destroyed at the same time when needed.
+
+            number_of_segments * segment_size can be used to compute the number of items that can be stored.
+            \post
+            - All items stored are destroyed.
+            - Clear is not called on the items.
+            - The new configuration is applied.
+        */
+        void discard_and_change_configuration(size_t number_of_segments, size_t segment_size)
+        {
+            this->discard_and_configure(number_of_segments, segment_size);
+        }
+
+        /**
+            \brief Changes the number of segments without discarding the stored items.
+            \param[in] number_of_segments   The new number of segments, must not be zero.
+
+            Takes time proportional to the number of segments, not to the number of items. Items stay
+            at their location in memory, except up to segment_size items that wrap around the end of
+            the layout. When shrinking below size(), the oldest items are removed.
+            Throws an exception if number_of_segments is zero or the ring buffer is not configured.
+        */
+        void resize_segments(size_t number_of_segments)
+        {
+            this->relayout_segments(number_of_segments);
+        }
+
+        /**
+            \brief Hands the retired segments over, so they can be freed on another thread.
+            \param[in,out] retired  Receives the retired segments, destroying them frees the memory.
+
+            Pass the same vector again after destroying its segments, e.g. with clear(), its capacity
+            is reused for retiring segments, so handing them over does not allocate.
+        */
+        void take_retired_segments(std::vector<segment_type>& retired)
+        {
+            this->get_segment_table().take_retired(retired);
+        }
+
+        /**
+            \brief Sets a handler that takes over complete segments evicted from a full ring buffer.
+            \param[in] handler  The handler, an empty handler disables the handover.
+
+            Only used while an eviction handler is set, which still receives the evicted runs that
+            are not complete segments. The handler swaps the evicted segment with an unallocated segment,
+            which is allocated when it is needed again, or with an allocated segment of the same size, e.g.
+            a segment handed over before whose items are not needed anymore. The items of the evicted
+            segment stay valid as long as the handler keeps it, e.g. to write them on another thread.
+        */
+        void set_segment_handover_handler(handover_handler_type handler)
+        {
+            this->get_segment_table().set_handover_handler(std::move(handler));
+        }
+    };
+
+    /**
+        \brief A ring buffer implementation for a large number of items with a geometry known at compile time.
+
+         Behaves like large_ring_buffer, but number_of_segments and segment_size are template
+         parameters. The compiler folds all index computations and the segment table is stored
+         inline in the object.
+    */
+    template <typename value_type, size_t number_of_segments, size_t segment_size, typename clear_handler_type = noop_clear_handler<value_type> >
+    class static_large_ring_buffer : public basic_large_ring_buffer<value_type, clear_handler_type, static_segment_table<value_type, number_of_segments, segment_size> >
+    {
     };
 }
@@ -0,0 +1,197 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+\file
+\brief Contains platform specific functions to reserve, commit and lock virtual memory pages, used internally
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief Platform specific functions to reserve, commit and decommit virtual memory.
+    */
+    class virtual_memory
+    {
+    public:
+        /**
+            \brief Returns the size of a memory page.
+            \return The size of a memory page in bytes.
+        */
+        static size_t get_page_size()
+        {
+#if defined(_WIN32)
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#else
+            return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        }
+
+        /**
+            \brief Reserves address space without committing memory.
+            \param[in] size     The number of bytes to reserve, a multiple of the page size.
+            \return The start of the reserved range.
+            Throws std::bad_alloc if the address space cannot be reserved.
+        */
+        static void* reserve(size_t size)
+        {
+#if defined(_WIN32)
+            void* result = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+            void* result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (result == MAP_FAILED)
+            {
+                result = nullptr;
+            }
+#endif
+            if (!result)
+            {
+                throw std::bad_alloc();
+            }
+            return result;
+        }
+
+        /**
+            \brief Releases a reserved range.
+            \param[in] address  The start of the reserved range.
+            \param[in] size     The number of bytes reserved.
+        */
+        static void release(void* address, size_t size)
+        {
+#if defined(_WIN32)
+            (void)size;
+            VirtualFree(address, 0, MEM_RELEASE);
+#else
+            munmap(address, size);
+#endif
+        }
+
+        /**
+            \brief Makes pages of a reserved range readable and writable.
+            \param[in] address  The start of the pages, page aligned.
+            \param[in] size     The number of bytes, a multiple of the page size.
+            Throws std::bad_alloc if the memory cannot be committed.
+        */
+        static void commit(void* address, size_t size)
+        {
+#if defined(_WIN32)
+            const bool committed = VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+            const bool committed = mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+            if (!committed)
+            {
+                throw std::bad_alloc();
+            }
+        }
+
+        /**
+            \brief Returns the memory of pages to the operating system, the address space stays reserved.
+            \param[in] address  The start of the pages, page aligned.
+            \param[in] size     The number of bytes, a multiple of the page size.
+        */
+        static void decommit(void* address, size_t size)
+        {
+#if defined(_WIN32)
+            VirtualFree(address, size, MEM_DECOMMIT);
+#else
+            madvise(address, size, MADV_DONTNEED);
+            mprotect(address, size, PROT_NONE);
+#endif
+        }
+
+        /**
+            \brief Writes one byte of every page of memory with its own value, so the pages are backed by physical memory.
+            \param[in] address  The start of the memory.
+            \param[in] size     The number of bytes.
+
+            Reading is not enough, untouched anonymous pages are mapped to a shared zero page on read and fault again on the first write.
+            The memory must not be written concurrently.
+        */
+        static void touch(void* address, size_t size)
+        {
+            const std::uintptr_t page_size = get_page_size();
+            const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(address) + size;
+            for (std::uintptr_t page = reinterpret_cast<std::uintptr_t>(address); page < end; page = (page / page_size + 1) * page_size)
+            {
+                volatile char* byte = reinterpret_cast<volatile char*>(page);
+                *byte = *byte;
+            }
+        }
+
+        /**
+            \brief Locks memory in physical memory, so accessing it does not cause page faults.
+            \param[in] address  The start of the memory.
+            \param[in] size     The number of bytes.
+            \return True if the memory is locked, false if e.g. the limit for locked memory is exceeded.
+        */
+        static bool lock(const void* address, size_t size)
+        {
+#if defined(_WIN32)
+            return VirtualLock(const_cast<void*>(address), size) != 0;
+#else
+            return mlock(address, size) == 0;
+#endif
+        }
+
+        /**
+            \brief Unlocks memory locked by lock().
+            \param[in] address  The start of the memory.
+            \param[in] size     The number of bytes.
+        */
+        static void unlock(const void* address, size_t size)
+        {
+#if defined(_WIN32)
+            VirtualUnlock(const_cast<void*>(address), size);
+#else
+            munlock(address, size);
+#endif
+        }
+    };
+}
@@ -0,0 +1,340 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains an allocator that places segments on transparent huge pages and a chosen NUMA node
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#if defined(__linux__)
+#include "detail/virtual_memory.hpp"
+#include <sys/syscall.h>
+#endif
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief Counters of a huge_page_allocator, shared by all copies of the allocator.
+    */
+    struct huge_page_statistics
+    {
+        /**
+            \brief The number of allocations currently advised with madvise(MADV_HUGEPAGE).
+
+            The kernel decides whether advised memory is actually backed by huge pages,
+            see AnonHugePages in /proc/self/smaps for the memory that is.
+        */
+        std::atomic<size_t> advised_huge_page_allocations{0};
+
+        /**
+            \brief The number of allocations currently not advised for transparent huge pages.
+        */
+        std::atomic<size_t> regular_allocations{0};
+
+        /**
+            \brief The number of allocations that could not be bound to the requested NUMA node.
+        */
+        std::atomic<size_t> numa_bind_failures{0};
+    };
+
+    /**
+        \brief An allocator for segments that uses transparent huge pages and NUMA placement.
+
+        Allocations of at least one huge page are aligned to the huge page size and advised
+        with madvise(MADV_HUGEPAGE), so a scan over a segment needs fewer TLB entries.
+        If a NUMA node is given, the pages are bound to that node with mbind (preferred policy).
+        Otherwise the pages are placed by first touch, i.e. on the node of the thread that
+        constructs the segment, which is the thread that adds items to the ring buffer.
+
+        Huge pages and NUMA binding are only supported on Linux, other platforms use regular allocations.
+        Use it with large_ring_buffer:
+        \code
+        large_ring_buffer<int, noop_clear_handler<int>, huge_page_allocator<int> > ringbuffer(100, 1 << 20, huge_page_allocator<int>(0));
+        \endcode
+    */
+    template <typename value_type_>
+    class huge_page_allocator
+    {
+    public:
+        /**
+            \brief The type of the allocated items.
+        */
+        typedef value_type_ value_type;
+
+        /**
+            \brief Constructs an allocator that places pages by first touch.
+        */
+        huge_page_allocator()
+            : huge_page_allocator(-1)
+        {
+        }
+
+        /**
+            \brief Constructs an allocator.
+            \param[in] numa_node    The NUMA node the pages are bound to, -1 to place pages by first touch.
+            \param[in] statistics   The counters to update, new counters are created if null.
+        */
+        explicit huge_page_allocator(int numa_node, std::shared_ptr<huge_page_statistics> statistics = nullptr)
+            : m_numa_node(numa_node)
+            , m_statistics(statistics ? std::move(statistics) : std::make_shared<huge_page_statistics>())
+        {
+        }
+
+        /**
+            \brief Constructs an allocator for another type sharing the configuration and the counters.
+            \param[in] other    The allocator to copy.
+        */
+        template <typename other_type>
+        huge_page_allocator(const huge_page_allocator<other_type>& other)
+            : m_numa_node(other.get_numa_node())
+            , m_statistics(other.get_statistics())
+        {
+        }
+
+        /**
+            \brief Returns the NUMA node the pages are bound to.
+            \return The NUMA node, -1 if pages are placed by first touch.
+        */
+        int get_numa_node() const
+        {
+            return m_numa_node;
+        }
+
+        /**
+            \brief Returns the counters of the allocator.
+            \return The counters of the allocator.
+        */
+        const std::shared_ptr<huge_page_statistics>& get_statistics() const
+        {
+            return m_statistics;
+        }
+
+        /**
+            \brief Returns the size of a transparent huge page.
+            \return The size of a transparent huge page in bytes, 0 if transparent huge pages are not available.
+        */
+        static size_t get_huge_page_size()
+        {
+            static const size_t huge_page_size = read_huge_page_size();
+            return huge_page_size;
+        }
+
+        /**
+            \brief Allocates memory for the given number of items.
+            \param[in] count    The number of items.
+            \return The allocated memory.
+            Throws std::bad_alloc if the memory cannot be allocated.
+        */
+        value_type* allocate(size_t count)
+        {
+            const size_t size = count * sizeof(value_type);
+            const size_t mapped_size = get_mapped_size(size);
+            if (!mapped_size)
+            {
+                m_statistics->regular_allocations++;
+                return static_cast<value_type*>(::operator new(size));
+            }
+#if defined(__linux__)
+            const size_t huge_page_size = get_huge_page_size();
+            const bool use_huge_pages = huge_page_size && size >= huge_page_size;
+            //over allocate by one huge page to be able to align the start
+            const size_t alignment = use_huge_pages ? huge_page_size : virtual_memory::get_page_size();
+            const size_t reserved_size = mapped_size + (use_huge_pages ? huge_page_size : 0);
+            void* reserved = mmap(nullptr, reserved_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (reserved == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            char* start = static_cast<char*>(reserved);
+            char* aligned = start + (alignment - reinterpret_cast<std::uintptr_t>(start) % alignment) % alignment;
+            if (aligned != start)
+            {
+                munmap(start, static_cast<size_t>(aligned - start));
+            }
+            char* end = start + reserved_size;
+            if (aligned + mapped_size != end)
+            {
+                munmap(aligned + mapped_size, static_cast<size_t>(end - aligned - mapped_size));
+            }
+            if (use_huge_pages)
+            {
+                madvise(aligned, mapped_size, MADV_HUGEPAGE);
+                m_statistics->advised_huge_page_allocations++;
+            }
+            else
+            {
+                m_statistics->regular_allocations++;
+            }
+            if (m_numa_node >= 0 && !bind(aligned, mapped_size))
+            {
+                m_statistics->numa_bind_failures++;
+            }
+            return reinterpret_cast<value_type*>(aligned);
+#else
+            throw std::bad_alloc();
+#endif
+        }
+
+        /**
+            \brief Frees memory allocated with allocate().
+            \param[in] items    The allocated memory.
+            \param[in] count    The number of items passed to allocate().
+        */
+        void deallocate(value_type* items, size_t count)
+        {
+            const size_t size = count * sizeof(value_type);
+            const size_t mapped_size = get_mapped_size(size);
+            if (!mapped_size)
+            {
+                m_statistics->regular_allocations--;
+                ::operator delete(items);
+                return;
+            }
+#if defined(__linux__)
+            const size_t huge_page_size = get_huge_page_size();
+            if (huge_page_size && size >= huge_page_size)
+            {
+                m_statistics->advised_huge_page_allocations--;
+            }
+            else
+            {
+                m_statistics->regular_allocations--;
+            }
+            munmap(items, mapped_size);
+#endif
+        }
+
+        /**
+            \brief Returns true if memory allocated by one allocator can be freed by the other one.
+            \param[in] other    The allocator to compare with.
+            \return True if both allocators share the configuration and the counters.
+        */
+        template <typename other_type>
+        bool operator==(const huge_page_allocator<other_type>& other) const
+        {
+            return m_numa_node == other.get_numa_node() && m_statistics == other.get_statistics();
+        }
+
+        /**
+            \brief Returns true if memory allocated by one allocator cannot be freed by the other one.
+            \param[in] other    The allocator to compare with.
+            \return True if the allocators differ in the configuration or the counters.
+        */
+        template <typename other_type>
+        bool operator!=(const huge_page_allocator<other_type>& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        // the size of the mapping for an allocation, 0 if it uses the regular heap
+        size_t get_mapped_size(size_t size) const
+        {
+#if defined(__linux__)
+            const size_t huge_page_size = get_huge_page_size();
+            if (huge_page_size && size >= huge_page_size)
+            {
+                return (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+            }
+            if (m_numa_node >= 0 && size)
+            {
+                //binding needs whole pages
+                const size_t page_size = virtual_memory::get_page_size();
+                return (size + page_size - 1) / page_size * page_size;
+            }
+#endif
+            (void)size;
+            return 0;
+        }
+
+        static size_t read_huge_page_size()
+        {
+            size_t result = 0;
+#if defined(__linux__)
+            char mode[128] = {};
+            std::FILE* enabled = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+            if (enabled)
+            {
+                const size_t length = std::fread(mode, 1, sizeof(mode) - 1, enabled);
+                mode[length] = 0;
+                std::fclose(enabled);
+            }
+            //madvise has no effect if transparent huge pages are disabled
+            if (mode[0] && !std::strstr(mode, "[never]"))
+            {
+                unsigned long long size = 2 * 1024 * 1024;
+                std::FILE* file = std::fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+                if (file)
+                {
+                    if (std::fscanf(file, "%llu", &size) != 1)
+                    {
+                        size = 2 * 1024 * 1024;
+                    }
+                    std::fclose(file);
+                }
+                result = static_cast<size_t>(size);
+            }
+#endif
+            return result;
+        }
+
+#if defined(__linux__)
+        bool bind(void* address, size_t size) const
+        {
+            //mbind without a dependency on libnuma, MPOL_PREFERRED falls back to other nodes if the node is full
+            const int mpol_preferred = 1;
+            const size_t max_nodes = 1024;
+            const size_t bits_per_word = 8 * sizeof(unsigned long);
+            if (static_cast<size_t>(m_numa_node) >= max_nodes)
+            {
+                return false;
+            }
+            unsigned long mask[max_nodes / bits_per_word] = {};
+            mask[m_numa_node / bits_per_word] = 1ul << (m_numa_node % bits_per_word);
+            return syscall(SYS_mbind, address, size, mpol_preferred, mask, max_nodes + 1, 0) == 0;
+        }
+#endif
+
+        int m_numa_node = -1;
+        std::shared_ptr<huge_page_statistics> m_statistics;
+    };
+}
@@ -0,0 +1,475 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+\file
+\brief Contains a ring buffer that maps its memory twice to provide wrap free contiguous access
+*/
+#pragma once
+#include "virtual_memory_large_ring_buffer.hpp"
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cstdio>
+#endif
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief Platform specific functions to map the same memory twice back to back.
+    */
+    class mirrored_memory
+    {
+    public:
+        /**
+            \brief Returns the granularity the size of a mirrored mapping must be a multiple of.
+            \return The granularity in bytes.
+        */
+        static size_t get_granularity()
+        {
+#if defined(_WIN32)
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwAllocationGranularity;
+#else
+            return virtual_memory::get_page_size();
+#endif
+        }
+
+        /**
+            \brief Maps size bytes of memory twice, the second mapping directly follows the first one.
+            \param[in] size     The number of bytes to map, a multiple of the granularity.
+            \return The start of the first mapping.
+            Throws std::bad_alloc if the memory cannot be mapped.
+        */
+        static void* map(size_t size)
+        {
+#if defined(_WIN32)
+            const unsigned long long size_value = size;
+            HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                static_cast<DWORD>(size_value >> 32), static_cast<DWORD>(size_value & 0xffffffffu), nullptr);
+            if (!mapping)
+            {
+                throw std::bad_alloc();
+            }
+            void* result = nullptr;
+            //another thread may take the address range between releasing and mapping, so retry
+            for (int attempt = 0; attempt < 16 && !result; ++attempt)
+            {
+                char* address = static_cast<char*>(VirtualAlloc(nullptr, 2 * size, MEM_RESERVE, PAGE_NOACCESS));
+                if (!address)
+                {
+                    break;
+                }
+                VirtualFree(address, 0, MEM_RELEASE);
+                void* first = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, address);
+                void* second = first ? MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, address + size) : nullptr;
+                if (first && second)
+                {
+                    result = first;
+                }
+                else if (first)
+                {
+                    UnmapViewOfFile(first);
+                }
+            }
+            CloseHandle(mapping);
+#else
+            void* result = nullptr;
+            const int file = create_file(size);
+            if (file < 0)
+            {
+                throw std::bad_alloc();
+            }
+            char* address = static_cast<char*>(mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+            if (address != MAP_FAILED)
+            {
+                if (mmap(address, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file, 0) != MAP_FAILED &&
+                    mmap(address + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file, 0) != MAP_FAILED)
+                {
+                    result = address;
+                }
+                else
+                {
+                    munmap(address, 2 * size);
+                }
+            }
+            close(file);
+#endif
+            if (!result)
+            {
+                throw std::bad_alloc();
+            }
+            return result;
+        }
+
+        /**
+            \brief Unmaps memory mapped by map().
+            \param[in] address  The start of the first mapping.
+            \param[in] size     The number of bytes mapped.
+        */
+        static void unmap(void* address, size_t size)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(static_cast<char*>(address) + size);
+            UnmapViewOfFile(address);
+#else
+            munmap(address, 2 * size);
+#endif
+        }
+
+    private:
+#if !defined(_WIN32)
+        static int create_file(size_t size)
+        {
+#if defined(__linux__)
+            const int file = memfd_create("cpplargeringbuffer", 0);
+#else
+            //anonymous shared memory object, the name is removed immediately
+            static int counter = 0;
+            char name[64];
+            std::snprintf(name, sizeof(name), "/cpplargeringbuffer.%ld.%d", static_cast<long>(getpid()), ++counter);
+            const int file = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+            if (file >= 0)
+            {
+                shm_unlink(name);
+            }
+#endif
+            if (file >= 0 && ftruncate(file, static_cast<off_t>(size)) != 0)
+            {
+                close(file);
+                return -1;
+            }
+            return file;
+        }
+#endif
+    };
+
+    /**
+        \brief A ring buffer for trivially copyable items whose content is always contiguous in memory.
+
+        The memory of the ring buffer is mapped twice back to back, so the items from the front
+        to the back can be accessed as one contiguous range starting at data() even if they wrap
+        around the end of the buffer. This allows to copy, write or view the whole content with
+        a single call. The capacity is rounded up to fill whole memory pages.
+    */
+    template <typename value_type>
+    class mirrored_ring_buffer
+    {
+    public:
+        /**
+            \brief Constructs a ring buffer object.
+        */
+        mirrored_ring_buffer() = default;
+
+        /**
+            \brief Constructs a ring buffer object with at least the given capacity.
+            \param[in] minimum_size  The minimum number of items that can be stored.
+        */
+        explicit mirrored_ring_buffer(size_t minimum_size)
+        {
+            discard_and_change_configuration(minimum_size);
+        }
+
+        mirrored_ring_buffer(const mirrored_ring_buffer&) = delete;
+        mirrored_ring_buffer& operator=(const mirrored_ring_buffer&) = delete;
+
+        /**
+            \brief Destroys a ring buffer object.
+        */
+        ~mirrored_ring_buffer()
+        {
+            discard_and_change_configuration(0);
+        }
+
+        /**
+            \brief Destroyes all stored items and changes the capacity.
+            \param[in] minimum_size  The minimum number of items that can be stored, rounded up to fill whole memory pages.
+            Throws std::range_error if the size of the mapping cannot be represented.
+        */
+        void discard_and_change_configuration(size_t minimum_size)
+        {
+            static_assert(std::is_trivially_copyable<value_type>::value, "mirrored_ring_buffer requires a trivially copyable value_type.");
+            if (m_base)
+            {
+                mirrored_memory::unmap(m_base, m_max_size * sizeof(value_type));
+            }
+            m_base = nullptr;
+            m_start_index = 0;
+            m_size = 0;
+            m_max_size = 0;
+            if (minimum_size)
+            {
+                const size_t granularity = mirrored_memory::get_granularity();
+                //the memory is mapped twice and rounded up by up to sizeof(value_type) granules
+                if (minimum_size > (std::numeric_limits<size_t>::max() / 2 - granularity * sizeof(value_type)) / sizeof(value_type))
+                {
+                    throw std::range_error("Ringbuffer size too large.");
+                }
+                size_t bytes = ((minimum_size * sizeof(value_type) + granularity - 1) / granularity) * granularity;
+                while (bytes % sizeof(value_type) != 0)
+                {
+                    bytes += granularity;
+                }
+                m_base = static_cast<value_type*>(mirrored_memory::map(bytes));
+                m_max_size = bytes / sizeof(value_type);
+            }
+        }
+
+        /**
+            \brief Removes all items.
+        */
+        void clear()
+        {
+            m_start_index = 0;
+            m_size = 0;
+        }
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        /**
+            \brief Returns true if the maximum number of items are currently stored in the ring buffer.
+            \return True if the maximum number of items are currently stored in the ring buffer.
+        */
+        bool full() const
+        {
+            return m_max_size != 0 && m_size == m_max_size;
+        }
+
+        /**
+            \brief Returns the maximum number of items that can be stored in the ring buffer.
+            \return The maximum number of items that can be stored in the ring buffer.
+        */
+        size_t get_max_size() const
+        {
+            return m_max_size;
+        }
+
+        /**
+            \brief Returns the item at the front, the following size() - 1 items are stored contiguously.
+            \return The item at the front of the ring buffer.
+        */
+        value_type* data()
+        {
+            return m_base + m_start_index;
+        }
+
+        /**
+            \brief Returns the item at the front, the following size() - 1 items are stored contiguously.
+            \return The item at the front of the ring buffer.
+        */
+        const value_type* data() const
+        {
+            return m_base + m_start_index;
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        value_type& operator[](size_t index)
+        {
+            return data()[index];
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        const value_type& operator[](size_t index) const
+        {
+            return data()[index];
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+            Throws an exception if the index is out of bounds.
+        */
+        const value_type& at(size_t index) const
+        {
+            if (index >= size())
+            {
+                throw std::range_error("Ringbuffer index out of bounds.");
+            }
+            return data()[index];
+        }
+
+        /**
+            \brief Returns the item at the front of the ring buffer.
+            \return The item at the front of the ring buffer.
+        */
+        const value_type& front() const
+        {
+            assert(!empty());
+            return data()[0];
+        }
+
+        /**
+            \brief Returns the item at the back of the ring buffer.
+            \return The item at the back of the ring buffer.
+        */
+        const value_type& back() const
+        {
+            assert(!empty());
+            return data()[m_size - 1];
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+                   Overwrites an item at the front if the ring buffer is full.
+            \param[in] item     The item to add.
+        */
+        void push_back(const value_type& item)
+        {
+            assert(m_max_size);
+            //the position after the back is always inside the mirrored range
+            m_base[m_start_index + m_size] = item;
+            if (m_size == m_max_size)
+            {
+                advance_start(1);
+            }
+            else
+            {
+                ++m_size;
+            }
+        }
+
+        /**
+            \brief Adds items at the back of the ring buffer using a single copy.
+                   Overwrites items at the front if the ring buffer is full.
+            \param[in] items    The items to add.
+            \param[in] count    The number of items to add.
+        */
+        void push_back(const value_type* items, size_t count)
+        {
+            assert(m_max_size || !count);
+            if (count > m_max_size)
+            {
+                //only the last items fit
+                items += count - m_max_size;
+                count = m_max_size;
+            }
+            //items past the end of the buffer land in the mirror and overwrite the front
+            size_t index = m_start_index + m_size;
+            if (index >= m_max_size)
+            {
+                index -= m_max_size;
+            }
+            if (count)
+            {
+                std::memcpy(m_base + index, items, count * sizeof(value_type));
+            }
+            if (m_size + count > m_max_size)
+            {
+                advance_start(m_size + count - m_max_size);
+                m_size = m_max_size;
+            }
+            else
+            {
+                m_size += count;
+            }
+        }
+
+        /**
+            \brief Removes an item at the front of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_front()
+        {
+            pop_front(1);
+        }
+
+        /**
+            \brief Removes items at the front of the ring buffer.
+            \param[in] count    The number of items to remove, must not be larger than size().
+        */
+        void pop_front(size_t count)
+        {
+            assert(count <= m_size);
+            advance_start(count);
+            m_size -= count;
+        }
+
+        /**
+            \brief Removes an item at the back of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_back()
+        {
+            assert(!empty());
+            --m_size;
+        }
+
+    private:
+        void advance_start(size_t count)
+        {
+            m_start_index += count;
+            if (m_start_index >= m_max_size)
+            {
+                m_start_index -= m_max_size;
+            }
+        }
+
+        value_type* m_base = nullptr;
+        size_t m_start_index = 0;
+        size_t m_size = 0;
+        size_t m_max_size = 0;
+    };
+}
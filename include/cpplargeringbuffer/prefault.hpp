@@ -0,0 +1,120 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+\file
+\brief Contains functions to allocate, touch and lock all segments of a ring buffer up front
+*/
+#pragma once
+#include "virtual_memory_large_ring_buffer.hpp"
+#include <stdexcept>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief Options for prefault().
+    */
+    struct prefault_options
+    {
+        /**
+            \brief The number of threads constructing the items, the allocator must be thread safe if it is more than one.
+        */
+        size_t threads = 1;
+
+        /**
+            \brief Locks the segments in physical memory, so accessing them never causes a page fault.
+        */
+        bool lock_memory = false;
+
+        /**
+            \brief Never frees the segments, sets release_mode::never.
+        */
+        bool keep_segments = true;
+    };
+
+    /**
+        \brief Allocates and touches all segments of a ring buffer, so adding items later neither allocates nor page faults.
+        \param[in] ring_buffer  The ring buffer, any basic_large_ring_buffer.
+        \param[in] options      The options.
+
+        Call it after configuring the ring buffer, e.g. at startup of a latency critical service.
+        After reserve_all() one byte of every page of every segment is written with its own value, because
+        constructing the items does not necessarily write their memory, e.g. zero_page_allocator leaves
+        trivial items on zero pages, and the segments might not be backed by physical memory otherwise.
+        Throws std::runtime_error if the memory cannot be locked, e.g. because the limit for locked
+        memory (RLIMIT_MEMLOCK) is too low. Segments locked before stay locked.
+    */
+    template <typename ring_buffer_type>
+    void prefault(ring_buffer_type& ring_buffer, const prefault_options& options = prefault_options())
+    {
+        if (options.keep_segments)
+        {
+            segment_release_policy policy = ring_buffer.get_segment_release_policy();
+            policy.mode = release_mode::never;
+            ring_buffer.set_segment_release_policy(policy);
+        }
+        ring_buffer.reserve_all(options.threads);
+        typedef typename ring_buffer_type::iterator::value_type value_type;
+        ring_buffer.for_each_segment([](value_type* items, size_t count)
+        {
+            virtual_memory::touch(items, count * sizeof(value_type));
+        });
+        if (options.lock_memory)
+        {
+            ring_buffer.for_each_segment([](const value_type* items, size_t count)
+            {
+                if (!virtual_memory::lock(items, count * sizeof(value_type)))
+                {
+                    throw std::runtime_error("The memory of a segment cannot be locked.");
+                }
+            });
+        }
+    }
+
+    /**
+        \brief Unlocks the segments locked by prefault().
+        \param[in] ring_buffer  The ring buffer.
+
+        Call it before segments are freed, otherwise the memory may stay locked after it is returned to the allocator.
+    */
+    template <typename ring_buffer_type>
+    void unlock_segments(ring_buffer_type& ring_buffer)
+    {
+        typedef typename ring_buffer_type::iterator::value_type value_type;
+        ring_buffer.for_each_segment([](const value_type* items, size_t count)
+        {
+            virtual_memory::unlock(items, count * sizeof(value_type));
+        });
+    }
+}
@@ -0,0 +1,191 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains a large ring buffer that removes items older than a retention period
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A large ring buffer that keeps the items of a retention period, e.g. the last 15 minutes.
+
+        projection_type returns the timestamp of an item, items must be added in ascending timestamp
+        order. Adding an item removes the items that are older than the timestamp of the new item minus
+        the retention period; expire() does the same for a given time, e.g. from a timer. Items are
+        removed in bulk with expire_front(), whole segments are removed without looking at each item.
+        The capacity of number_of_segments * segment_size items still applies.
+    */
+    template <typename value_type, typename projection_type, typename retention_type, typename clear_handler_type = noop_clear_handler<value_type> >
+    class retention_large_ring_buffer
+    {
+    public:
+        /**
+            \brief Constructs a ring buffer object.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] retention             The period items are kept, relative to the newest timestamp.
+            \param[in] projection            Returns the timestamp of an item.
+        */
+        retention_large_ring_buffer(size_t number_of_segments, size_t segment_size, retention_type retention, projection_type projection = projection_type())
+            : m_ring_buffer(number_of_segments, segment_size)
+            , m_retention(retention)
+            , m_projection(projection)
+        {
+        }
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            return m_ring_buffer.size();
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            return m_ring_buffer.empty();
+        }
+
+        /**
+            \brief Returns the retention period.
+            \return The retention period.
+        */
+        const retention_type& get_retention() const
+        {
+            return m_retention;
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        const value_type& operator[](size_t index) const
+        {
+            return m_ring_buffer[index];
+        }
+
+        /**
+            \brief Returns the item at the front of the ring buffer.
+            \return The item at the front of the ring buffer.
+        */
+        const value_type& front() const
+        {
+            return m_ring_buffer.front();
+        }
+
+        /**
+            \brief Returns the item at the back of the ring buffer.
+            \return The item at the back of the ring buffer.
+        */
+        const value_type& back() const
+        {
+            return m_ring_buffer.back();
+        }
+
+        /**
+            \brief Returns the underlying ring buffer, e.g. to iterate the items.
+            \return The underlying ring buffer.
+        */
+        const large_ring_buffer<value_type, clear_handler_type>& get_ring_buffer() const
+        {
+            return m_ring_buffer;
+        }
+
+        /**
+            \brief Removes expired items and adds an item at the back of the ring buffer.
+                   Overwrites an item at the front if the ring buffer is still full.
+            \param[in] item     The item to add, its timestamp must not be less than the one of the back item.
+        */
+        void push_back(const value_type& item)
+        {
+            expire(m_projection(item));
+            m_ring_buffer.push_back(item);
+        }
+
+        /**
+            \brief Removes the items older than now minus the retention period.
+            \param[in] now  The current time.
+            \return The number of items removed.
+
+            Unsigned timestamps less than the retention period do not expire any items.
+        */
+        template <typename time_type>
+        size_t expire(const time_type& now)
+        {
+            if (is_before_retention(now, std::is_unsigned<time_type>()))
+            {
+                //now - retention would wrap around, no item can be that old
+                return 0;
+            }
+            return m_ring_buffer.expire_front(now - m_retention, m_projection);
+        }
+
+        /**
+            \brief Removes an item at the front of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_front()
+        {
+            m_ring_buffer.pop_front();
+        }
+
+    private:
+        template <typename time_type>
+        bool is_before_retention(const time_type& now, std::true_type) const
+        {
+            return now < static_cast<time_type>(m_retention);
+        }
+
+        template <typename time_type>
+        bool is_before_retention(const time_type&, std::false_type) const
+        {
+            return false;
+        }
+
+        large_ring_buffer<value_type, clear_handler_type> m_ring_buffer;
+        retention_type m_retention;
+        projection_type m_projection;
+    };
+}
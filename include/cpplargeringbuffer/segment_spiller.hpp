@@ -0,0 +1,287 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+\file
+\brief Contains a segment spiller that appends evicted items of a large ring buffer to a file
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief Appends items that are evicted from a full ring buffer to a file using a background thread.
+
+        Turns a large ring buffer into a bounded in-memory tail of an on-disk log.
+        The spiller is attached to a ring buffer as its eviction and segment handover handler, so a
+        full ring buffer evicts a run of items up to the end of a segment at a time. Complete segments
+        are taken over from the ring buffer and written by the background thread without copying
+        the items. The ring buffer gets a segment written before in exchange, so no memory is allocated
+        once the writer keeps up. Evicted runs that are not complete segments, e.g. after pop_front(),
+        are copied. The file contains the evicted items in the order of their eviction.
+
+        extend_back() only waits for the background thread if max_pending_segments segments
+        are waiting to be written, which bounds the memory used when the disk is too slow.
+        Only available for trivially copyable value types.
+    */
+    template <typename value_type, typename allocator_type = std::allocator<value_type> >
+    class segment_spiller
+    {
+    public:
+        /**
+            \brief The type of a segment of the ring buffer.
+        */
+        typedef std::vector<value_type, allocator_type> segment_type;
+
+        /**
+            \brief Constructs a spiller object and opens the file for appending.
+            \param[in] file_name                The file the evicted items are appended to.
+            \param[in] max_pending_segments     The number of segments that can wait to be written before evicting blocks, at least one.
+            Throws an exception if the file cannot be opened.
+        */
+        explicit segment_spiller(const std::string& file_name, size_t max_pending_segments = 4)
+            : m_max_pending_segments(max_pending_segments ? max_pending_segments : 1)
+        {
+            static_assert(std::is_trivially_copyable<value_type>::value, "segment_spiller requires a trivially copyable value_type.");
+            m_file = std::fopen(file_name.c_str(), "ab");
+            if (!m_file)
+            {
+                throw std::runtime_error("Spill file could not be opened.");
+            }
+            m_thread = std::thread([this]() { write_runs(); });
+        }
+
+        segment_spiller(const segment_spiller&) = delete;
+        segment_spiller& operator=(const segment_spiller&) = delete;
+
+        /**
+            \brief Waits for all pending writes and closes the file.
+        */
+        ~segment_spiller()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_condition.notify_all();
+            m_thread.join();
+            std::fclose(m_file);
+        }
+
+        /**
+            \brief Sets this spiller as eviction and segment handover handler of a ring buffer.
+            \param[in] ring_buffer   The ring buffer whose evicted items are appended to the file.
+        */
+        template <typename clear_handler_type>
+        void attach(large_ring_buffer<value_type, clear_handler_type, allocator_type>& ring_buffer)
+        {
+            {
+                //buffers for copied runs use the allocator of the segments, so they can be handed over
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_allocator = ring_buffer.get_allocator();
+            }
+            ring_buffer.set_eviction_handler([this](const value_type* items, size_t count)
+            {
+                evict(items, count);
+            });
+            ring_buffer.set_segment_handover_handler([this](segment_type& segment)
+            {
+                hand_over(segment);
+            });
+        }
+
+        /**
+            \brief Removes this spiller as eviction and segment handover handler of a ring buffer and waits for pending writes.
+            \param[in] ring_buffer   The ring buffer the spiller was attached to.
+            Throws an exception if writing failed.
+        */
+        template <typename clear_handler_type>
+        void detach(large_ring_buffer<value_type, clear_handler_type, allocator_type>& ring_buffer)
+        {
+            ring_buffer.set_eviction_handler(nullptr);
+            ring_buffer.set_segment_handover_handler(nullptr);
+            flush();
+        }
+
+        /**
+            \brief Waits until all evicted items have been written and flushes the file.
+            Throws an exception if writing failed.
+        */
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return get_pending_count() == 0 || m_error; });
+            throw_on_error();
+            if (std::fflush(m_file) != 0)
+            {
+                throw std::runtime_error("Spill file could not be written.");
+            }
+        }
+
+        /**
+            \brief Returns the number of items written to the file so far.
+            \return The number of items written to the file so far.
+        */
+        size_t get_spilled_count() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_spilled_count;
+        }
+
+    private:
+        struct run
+        {
+            segment_type items;
+            size_t count;
+        };
+
+        // copies an evicted run that is not a complete segment
+        void evict(const value_type* items, size_t count)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            wait_for_capacity(lock);
+            if (!m_free.empty() && m_free.back().size() >= count)
+            {
+                //moving keeps the allocator of the buffer
+                segment_type buffer(std::move(m_free.back()));
+                m_free.pop_back();
+                copy_items(buffer.data(), items, count);
+                m_queue.push_back(run{ std::move(buffer), count });
+            }
+            else
+            {
+                segment_type buffer(items, items + count, m_allocator);
+                m_queue.push_back(run{ std::move(buffer), count });
+            }
+            m_condition.notify_all();
+        }
+
+        // takes the evicted segment and replaces it with a written one of the same size or an unallocated one
+        void hand_over(segment_type& segment)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            wait_for_capacity(lock);
+            m_queue.push_back(run{ segment_type(segment.get_allocator()), segment.size() });
+            m_queue.back().items.swap(segment);
+            //swapping vectors with unequal allocators is undefined
+            if (!m_free.empty() && m_free.back().size() == m_queue.back().count && m_free.back().get_allocator() == segment.get_allocator())
+            {
+                segment.swap(m_free.back());
+                m_free.pop_back();
+            }
+            m_condition.notify_all();
+        }
+
+        // waits until another run can be queued, throws if writing failed
+        void wait_for_capacity(std::unique_lock<std::mutex>& lock)
+        {
+            m_condition.wait(lock, [this]() { return get_pending_count() < m_max_pending_segments || m_error; });
+            throw_on_error();
+        }
+
+        size_t get_pending_count() const
+        {
+            return m_queue.size() + (m_writing ? 1 : 0);
+        }
+
+        void write_runs()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_condition.wait(lock, [this]() { return !m_queue.empty() || m_stop; });
+                if (m_queue.empty())
+                {
+                    break;
+                }
+
+                run current = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_writing = true;
+                lock.unlock();
+                const bool written = std::fwrite(current.items.data(), sizeof(value_type), current.count, m_file) == current.count;
+                lock.lock();
+                m_writing = false;
+
+                if (written)
+                {
+                    m_spilled_count += current.count;
+                }
+                else
+                {
+                    m_error = true;
+                }
+                //the buffer is reused for the next evicted items
+                if (m_free.size() < m_max_pending_segments)
+                {
+                    m_free.push_back(std::move(current.items));
+                }
+                m_condition.notify_all();
+            }
+        }
+
+        void throw_on_error() const
+        {
+            if (m_error)
+            {
+                throw std::runtime_error("Spill file could not be written.");
+            }
+        }
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<run> m_queue;            // runs to be written by the background thread
+        std::vector<segment_type> m_free;   // written buffers that are reused
+        allocator_type m_allocator;         // the allocator of the attached ring buffer
+        size_t m_max_pending_segments = 4;
+        size_t m_spilled_count = 0;
+        bool m_writing = false;
+        bool m_stop = false;
+        bool m_error = false;
+        std::FILE* m_file = nullptr;
+        std::thread m_thread;
+    };
+}
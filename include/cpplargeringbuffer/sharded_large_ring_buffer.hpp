@@ -0,0 +1,385 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/**
+\file
+\brief Contains a large ring buffer with one shard per producer thread and an ordered view over all shards
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief An input iterator over the items of a view that merges several sorted sequences.
+    */
+    template <typename view_type, typename item_type>
+    class merged_iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef typename std::remove_const<item_type>::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef item_type* pointer;
+        typedef item_type& reference;
+
+        /**
+            \brief Constructs the end iterator.
+        */
+        merged_iterator() = default;
+
+        /**
+            \brief Constructs an iterator to the current item of a view.
+            \param[in] view     The view.
+        */
+        explicit merged_iterator(view_type* view)
+            : m_view(view)
+        {
+        }
+
+        reference operator*() const
+        {
+            return m_view->current();
+        }
+
+        pointer operator->() const
+        {
+            return &m_view->current();
+        }
+
+        merged_iterator& operator++()
+        {
+            m_view->advance();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            m_view->advance();
+        }
+
+        bool operator==(const merged_iterator& other) const
+        {
+            return at_end() == other.at_end();
+        }
+
+        bool operator!=(const merged_iterator& other) const
+        {
+            return at_end() != other.at_end();
+        }
+
+    private:
+        bool at_end() const
+        {
+            return !m_view || m_view->at_end();
+        }
+
+        view_type* m_view = nullptr;
+    };
+
+    /**
+        \brief A set of large ring buffers, one per producer thread, that can be read in the order of a key.
+
+        Each producer thread appends to its own shard, the shard's mutex is only contended while
+        a reader holds an ordered_view. Readers see the items of all shards merged in the order of
+        the key returned by key_projection_type, e.g. a timestamp or a sequence number. The items of
+        each shard must be added in ascending key order. Items with the same key are ordered by shard.
+
+        An ordered_view holds the mutexes of ALL shards until it is destroyed, so every producer
+        blocks in push_back() meanwhile. Keep views short lived, e.g. iterate, pop_visited() and let
+        the view go out of scope. The shards stay locked because a producer adding to a full shard
+        overwrites its front, which would invalidate items the view refers to.
+    */
+    template <typename value_type, typename key_projection_type>
+    class sharded_large_ring_buffer
+    {
+    public:
+        /**
+            \brief The type of the key the items are ordered by.
+        */
+        typedef typename std::decay<decltype(std::declval<key_projection_type>()(std::declval<const value_type&>()))>::type key_type;
+
+        /**
+            \brief A locked view of all shards that iterates the items in key order.
+
+            All shards are locked while the view exists, producers wait for the view to be destroyed.
+            Do not keep a view while waiting for something else, e.g. for producers.
+        */
+        class ordered_view
+        {
+        public:
+            /**
+                \brief An input iterator that merges the shards.
+            */
+            typedef merged_iterator<ordered_view, const value_type> iterator;
+
+            /**
+                \brief Locks all shards and prepares the merge.
+                \param[in] owner    The sharded ring buffer.
+            */
+            explicit ordered_view(sharded_large_ring_buffer& owner)
+                : m_owner(owner)
+                , m_next_indices(owner.m_shards.size(), 0)
+            {
+                for (size_t i = 0; i < owner.m_shards.size(); ++i)
+                {
+                    m_locks.emplace_back(owner.m_shards[i]->mutex);
+                    push_cursor(i, 0);
+                }
+            }
+
+            ordered_view(ordered_view&&) = default;
+
+            /**
+                \brief Returns an iterator to the item with the smallest key.
+                \return An iterator to the item with the smallest key.
+            */
+            iterator begin()
+            {
+                return iterator(this);
+            }
+
+            /**
+                \brief Returns the end iterator.
+                \return The end iterator.
+            */
+            iterator end()
+            {
+                return iterator();
+            }
+
+            /**
+                \brief Removes the items of all shards that have been iterated over.
+            */
+            void pop_visited()
+            {
+                for (size_t i = 0; i < m_owner.m_shards.size(); ++i)
+                {
+                    large_ring_buffer<value_type>& shard = m_owner.m_shards[i]->ring_buffer;
+                    shard.release_front(m_next_indices[i]);
+                    m_next_indices[i] = 0;
+                }
+                //restart the merge at the new fronts
+                m_cursors = cursor_queue();
+                for (size_t i = 0; i < m_owner.m_shards.size(); ++i)
+                {
+                    push_cursor(i, 0);
+                }
+            }
+
+        private:
+            template <typename, typename>
+            friend class merged_iterator;
+
+            struct cursor
+            {
+                key_type key;
+                size_t shard;
+                size_t index;
+            };
+
+            struct cursor_after
+            {
+                bool operator()(const cursor& first, const cursor& second) const
+                {
+                    return second.key < first.key || (!(first.key < second.key) && second.shard < first.shard);
+                }
+            };
+
+            typedef std::priority_queue<cursor, std::vector<cursor>, cursor_after> cursor_queue;
+
+            void push_cursor(size_t shard_index, size_t index)
+            {
+                const large_ring_buffer<value_type>& shard = m_owner.m_shards[shard_index]->ring_buffer;
+                if (index < shard.size())
+                {
+                    const cursor next = { m_owner.m_key_projection(shard[index]), shard_index, index };
+                    m_cursors.push(next);
+                }
+            }
+
+            const value_type& current() const
+            {
+                const cursor& top = m_cursors.top();
+                return m_owner.m_shards[top.shard]->ring_buffer[top.index];
+            }
+
+            bool at_end() const
+            {
+                return m_cursors.empty();
+            }
+
+            void advance()
+            {
+                const cursor top = m_cursors.top();
+                m_cursors.pop();
+                m_next_indices[top.shard] = top.index + 1;
+                push_cursor(top.shard, top.index + 1);
+            }
+
+            sharded_large_ring_buffer& m_owner;
+            std::vector<std::unique_lock<std::mutex> > m_locks;
+            cursor_queue m_cursors;
+            std::vector<size_t> m_next_indices; // per shard, the number of items visited
+        };
+
+        /**
+            \brief Constructs a ring buffer object.
+            \param[in] shard_count           The number of shards, usually the number of producer threads.
+            \param[in] number_of_segments    The number of segments of each shard.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] key_projection        Returns the key of an item.
+        */
+        sharded_large_ring_buffer(size_t shard_count, size_t number_of_segments, size_t segment_size, key_projection_type key_projection = key_projection_type())
+            : m_key_projection(key_projection)
+        {
+            for (size_t i = 0; i < shard_count; ++i)
+            {
+                m_shards.emplace_back(new shard(number_of_segments, segment_size));
+            }
+        }
+
+        sharded_large_ring_buffer(const sharded_large_ring_buffer&) = delete;
+        sharded_large_ring_buffer& operator=(const sharded_large_ring_buffer&) = delete;
+
+        /**
+            \brief Returns the number of shards.
+            \return The number of shards.
+        */
+        size_t get_shard_count() const
+        {
+            return m_shards.size();
+        }
+
+        /**
+            \brief Assigns a shard to the calling producer, shards are assigned round robin.
+            \return The index of the shard to use with push_back().
+        */
+        size_t acquire_shard()
+        {
+            return m_next_shard++ % m_shards.size();
+        }
+
+        /**
+            \brief Adds an item at the back of a shard.
+                   Overwrites an item at the front of the shard if the shard is full.
+            \param[in] shard_index  The shard of the calling producer.
+            \param[in] item         The item to add.
+        */
+        void push_back(size_t shard_index, const value_type& item)
+        {
+            shard& target = *m_shards[shard_index];
+            std::lock_guard<std::mutex> lock(target.mutex);
+            target.ring_buffer.push_back(item);
+        }
+
+        /**
+            \brief Returns the number of items stored in all shards.
+            \return The number of items stored in all shards.
+        */
+        size_t size() const
+        {
+            size_t result = 0;
+            for (const std::unique_ptr<shard>& current : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(current->mutex);
+                result += current->ring_buffer.size();
+            }
+            return result;
+        }
+
+        /**
+            \brief Returns the number of items that can be stored in all shards.
+            \return The number of items that can be stored in all shards.
+        */
+        size_t get_max_size() const
+        {
+            size_t result = 0;
+            for (const std::unique_ptr<shard>& current : m_shards)
+            {
+                result += current->ring_buffer.get_max_size();
+            }
+            return result;
+        }
+
+        /**
+            \brief Returns the number of segments allocated by all shards.
+            \return The number of segments allocated by all shards.
+        */
+        size_t get_used_segments() const
+        {
+            size_t result = 0;
+            for (const std::unique_ptr<shard>& current : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(current->mutex);
+                result += current->ring_buffer.get_used_segments();
+            }
+            return result;
+        }
+
+        /**
+            \brief Locks all shards and returns a view that iterates the items in key order.
+            \return The view, producers are blocked until it is destroyed.
+        */
+        ordered_view lock_ordered()
+        {
+            return ordered_view(*this);
+        }
+
+    private:
+        struct shard
+        {
+            shard(size_t number_of_segments, size_t segment_size)
+                : ring_buffer(number_of_segments, segment_size)
+            {
+            }
+
+            mutable std::mutex mutex;
+            large_ring_buffer<value_type> ring_buffer;
+        };
+
+        key_projection_type m_key_projection;
+        std::vector<std::unique_ptr<shard> > m_shards;
+        std::atomic<size_t> m_next_shard{0};
+    };
+}
@@ -0,0 +1,879 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+\file
+\brief Contains a large ring buffer that keeps older segments compressed in memory
+*/
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A simple and fast byte oriented LZ77 codec used to compress segments (default).
+
+        Works on the object representation of trivially copyable items.
+        A segment codec provides the following static functions:
+        - compress(const value_type* items, size_t count, std::vector<unsigned char>& out)
+        - decompress(const unsigned char* data, size_t size, value_type* items, size_t count)
+        If supports_random_access is true, items are compressed in independent blocks of
+        block_size items and it also provides
+        - decompress_block(const unsigned char* data, size_t size, size_t block_index, value_type* items, size_t count)
+    */
+    class simple_lz_codec
+    {
+    public:
+        /**
+            \brief Single items cannot be decompressed without decompressing the whole segment.
+        */
+        static const bool supports_random_access = false;
+
+        /**
+            \brief Compresses items.
+            \param[in]  items    The items to compress.
+            \param[in]  count    The number of items to compress.
+            \param[out] out      The compressed data.
+        */
+        template <typename value_type>
+        static void compress(const value_type* items, size_t count, std::vector<unsigned char>& out)
+        {
+            const unsigned char* input = reinterpret_cast<const unsigned char*>(items);
+            const size_t input_size = count * sizeof(value_type);
+            const size_t no_position = static_cast<size_t>(-1);
+            std::vector<size_t> table(hash_table_size, no_position);
+
+            out.clear();
+            size_t position = 0;
+            size_t literal_start = 0;
+            while (position + min_match_length <= input_size)
+            {
+                const std::uint32_t sequence = read_sequence(input + position);
+                const size_t hash = (sequence * 2654435761u) >> (32 - hash_bits);
+                const size_t candidate = table[hash];
+                table[hash] = position;
+                if (candidate != no_position && position - candidate <= max_offset && read_sequence(input + candidate) == sequence)
+                {
+                    size_t match_length = min_match_length;
+                    while (position + match_length < input_size && input[candidate + match_length] == input[position + match_length])
+                    {
+                        ++match_length;
+                    }
+                    write_number(position - literal_start, out);
+                    out.insert(out.end(), input + literal_start, input + position);
+                    write_number(match_length - min_match_length, out);
+                    write_number(position - candidate, out);
+                    position += match_length;
+                    literal_start = position;
+                }
+                else
+                {
+                    ++position;
+                }
+            }
+            //trailing literals, decompression stops when all items are restored
+            write_number(input_size - literal_start, out);
+            out.insert(out.end(), input + literal_start, input + input_size);
+        }
+
+        /**
+            \brief Decompresses items.
+            \param[in]  data     The compressed data.
+            \param[in]  size     The size of the compressed data.
+            \param[out] items    The decompressed items.
+            \param[in]  count    The number of items to decompress.
+            Throws an exception if the compressed data is corrupt.
+        */
+        template <typename value_type>
+        static void decompress(const unsigned char* data, size_t size, value_type* items, size_t count)
+        {
+            unsigned char* output = reinterpret_cast<unsigned char*>(items);
+            const size_t output_size = count * sizeof(value_type);
+            const unsigned char* data_end = data + size;
+            size_t position = 0;
+            while (position < output_size)
+            {
+                const size_t literal_length = read_number(data, data_end);
+                if (literal_length > output_size - position || literal_length > static_cast<size_t>(data_end - data))
+                {
+                    throw std::runtime_error("Compressed segment is corrupt.");
+                }
+                std::memcpy(output + position, data, literal_length);
+                data += literal_length;
+                position += literal_length;
+                if (position == output_size)
+                {
+                    break;
+                }
+
+                const size_t match_length = read_number(data, data_end) + min_match_length;
+                const size_t offset = read_number(data, data_end);
+                if (offset == 0 || offset > position || match_length > output_size - position)
+                {
+                    throw std::runtime_error("Compressed segment is corrupt.");
+                }
+                //matches may overlap, copy byte by byte
+                for (size_t i = 0; i < match_length; ++i, ++position)
+                {
+                    output[position] = output[position - offset];
+                }
+            }
+        }
+
+    private:
+        static const size_t min_match_length = 4;
+        static const size_t max_offset = 65535;
+        static const size_t hash_bits = 12;
+        static const size_t hash_table_size = size_t(1) << hash_bits;
+
+        static std::uint32_t read_sequence(const unsigned char* data)
+        {
+            std::uint32_t result;
+            std::memcpy(&result, data, sizeof(result));
+            return result;
+        }
+
+        static void write_number(size_t value, std::vector<unsigned char>& out)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<unsigned char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<unsigned char>(value));
+        }
+
+        static size_t read_number(const unsigned char*& data, const unsigned char* data_end)
+        {
+            size_t result = 0;
+            for (unsigned shift = 0; data != data_end && shift < sizeof(size_t) * 8; shift += 7)
+            {
+                const unsigned char byte = *data++;
+                result |= static_cast<size_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                {
+                    return result;
+                }
+            }
+            throw std::runtime_error("Compressed segment is corrupt.");
+        }
+    };
+
+    /**
+        \brief A frame of reference codec for integer items that change by small amounts, e.g. timestamps.
+
+        Items are compressed in blocks of block_size items. A block stores the first item,
+        the minimum difference between consecutive items and the bit packed differences relative
+        to that minimum. An offset table at the start of a segment allows decompressing single blocks,
+        so tiered_large_ring_buffer can read single items without decompressing the whole segment.
+        The decoding loops are kept simple so that compilers can vectorize them.
+    */
+    class frame_of_reference_codec
+    {
+    public:
+        /**
+            \brief Single blocks can be decompressed.
+        */
+        static const bool supports_random_access = true;
+
+        /**
+            \brief The number of items in a block.
+        */
+        static const size_t block_size = 64;
+
+        /**
+            \brief Compresses items.
+            \param[in]  items    The items to compress.
+            \param[in]  count    The number of items to compress.
+            \param[out] out      The compressed data.
+            Throws an exception if a block offset does not fit into 32 bits.
+        */
+        template <typename value_type>
+        static void compress(const value_type* items, size_t count, std::vector<unsigned char>& out)
+        {
+            static_assert(std::is_integral<value_type>::value && !std::is_same<value_type, bool>::value, "frame_of_reference_codec requires an integral value_type other than bool.");
+            const size_t block_count = (count + block_size - 1) / block_size;
+            out.assign(block_count * sizeof(std::uint32_t), 0);
+            std::uint64_t differences[block_size];
+            for (size_t block_index = 0; block_index < block_count; ++block_index)
+            {
+                const size_t first = block_index * block_size;
+                const size_t block_count_items = (count - first < block_size) ? count - first : block_size;
+                //block offsets are stored as 32 bit values
+                if (out.size() > UINT32_MAX)
+                {
+                    throw std::range_error("Compressed segment too large.");
+                }
+                const std::uint32_t offset = static_cast<std::uint32_t>(out.size());
+                std::memcpy(out.data() + block_index * sizeof(std::uint32_t), &offset, sizeof(offset));
+
+                //unsigned arithmetic wraps, so decreasing values work as well
+                std::uint64_t min_difference = ~std::uint64_t(0);
+                std::uint64_t max_difference = 0;
+                for (size_t i = 1; i < block_count_items; ++i)
+                {
+                    differences[i] = to_unsigned(items[first + i]) - to_unsigned(items[first + i - 1]);
+                    min_difference = differences[i] < min_difference ? differences[i] : min_difference;
+                    max_difference = differences[i] > max_difference ? differences[i] : max_difference;
+                }
+                if (block_count_items < 2)
+                {
+                    min_difference = 0;
+                }
+                unsigned bit_width = 0;
+                while (bit_width < 64 && ((max_difference - min_difference) >> bit_width) != 0)
+                {
+                    ++bit_width;
+                }
+
+                append(to_unsigned(items[first]), out);
+                append(min_difference, out);
+                out.push_back(static_cast<unsigned char>(bit_width));
+
+                //bit packed differences, padded to allow reading whole words
+                const size_t packed_start = out.size();
+                out.resize(packed_start + ((block_count_items - 1) * bit_width + 7) / 8 + sizeof(std::uint64_t), 0);
+                unsigned char* packed = out.data() + packed_start;
+                size_t bit_position = 0;
+                for (size_t i = 1; i < block_count_items; ++i, bit_position += bit_width)
+                {
+                    const std::uint64_t value = differences[i] - min_difference;
+                    for (unsigned bit = 0; bit < bit_width; ++bit)
+                    {
+                        if ((value >> bit) & 1)
+                        {
+                            const size_t position = bit_position + bit;
+                            packed[position / 8] = static_cast<unsigned char>(packed[position / 8] | (1u << (position % 8)));
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+            \brief Decompresses items.
+            \param[in]  data     The compressed data.
+            \param[in]  size     The size of the compressed data.
+            \param[out] items    The decompressed items.
+            \param[in]  count    The number of items to decompress.
+            Throws an exception if the compressed data is corrupt.
+        */
+        template <typename value_type>
+        static void decompress(const unsigned char* data, size_t size, value_type* items, size_t count)
+        {
+            const size_t block_count = (count + block_size - 1) / block_size;
+            for (size_t block_index = 0; block_index < block_count; ++block_index)
+            {
+                const size_t first = block_index * block_size;
+                decompress_block(data, size, block_index, items + first, (count - first < block_size) ? count - first : block_size);
+            }
+        }
+
+        /**
+            \brief Decompresses a single block.
+            \param[in]  data         The compressed data.
+            \param[in]  size         The size of the compressed data.
+            \param[in]  block_index  The index of the block to decompress.
+            \param[out] items        The decompressed items of the block.
+            \param[in]  count        The number of items in the block.
+            Throws an exception if the compressed data is corrupt.
+        */
+        template <typename value_type>
+        static void decompress_block(const unsigned char* data, size_t size, size_t block_index, value_type* items, size_t count)
+        {
+            static_assert(std::is_integral<value_type>::value && !std::is_same<value_type, bool>::value, "frame_of_reference_codec requires an integral value_type other than bool.");
+            std::uint32_t offset = 0;
+            if ((block_index + 1) * sizeof(offset) > size)
+            {
+                throw std::runtime_error("Compressed segment is corrupt.");
+            }
+            std::memcpy(&offset, data + block_index * sizeof(offset), sizeof(offset));
+            const size_t header_size = 2 * sizeof(std::uint64_t) + 1;
+            if (offset > size || size - offset < header_size)
+            {
+                throw std::runtime_error("Compressed segment is corrupt.");
+            }
+            const unsigned char* block = data + offset;
+            const std::uint64_t base = read_word(block);
+            const std::uint64_t min_difference = read_word(block + sizeof(std::uint64_t));
+            const unsigned bit_width = block[2 * sizeof(std::uint64_t)];
+            const unsigned char* packed = block + header_size;
+            if (bit_width > 64 || size - offset - header_size < (count ? ((count - 1) * bit_width + 7) / 8 + sizeof(std::uint64_t) : 0))
+            {
+                throw std::runtime_error("Compressed segment is corrupt.");
+            }
+
+            std::uint64_t differences[block_size];
+            const std::uint64_t mask = bit_width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bit_width) - 1;
+            if (bit_width <= 56)
+            {
+                //each value is contained in the word starting at its first byte
+                for (size_t i = 1; i < count; ++i)
+                {
+                    const size_t bit_position = (i - 1) * bit_width;
+                    differences[i] = (read_word(packed + bit_position / 8) >> (bit_position % 8)) & mask;
+                }
+            }
+            else
+            {
+                for (size_t i = 1; i < count; ++i)
+                {
+                    const size_t bit_position = (i - 1) * bit_width;
+                    const unsigned shift = static_cast<unsigned>(bit_position % 8);
+                    std::uint64_t value = read_word(packed + bit_position / 8) >> shift;
+                    if (shift)
+                    {
+                        value |= static_cast<std::uint64_t>(packed[bit_position / 8 + sizeof(std::uint64_t)]) << (64 - shift);
+                    }
+                    differences[i] = value & mask;
+                }
+            }
+
+            std::uint64_t value = base;
+            if (count)
+            {
+                items[0] = static_cast<value_type>(value);
+            }
+            for (size_t i = 1; i < count; ++i)
+            {
+                value += differences[i] + min_difference;
+                items[i] = static_cast<value_type>(value);
+            }
+        }
+
+    private:
+        template <typename value_type>
+        static std::uint64_t to_unsigned(value_type value)
+        {
+            return static_cast<std::uint64_t>(static_cast<typename std::make_unsigned<value_type>::type>(value));
+        }
+
+        static void append(std::uint64_t value, std::vector<unsigned char>& out)
+        {
+            const size_t position = out.size();
+            out.resize(position + sizeof(value));
+            std::memcpy(out.data() + position, &value, sizeof(value));
+        }
+
+        static std::uint64_t read_word(const unsigned char* data)
+        {
+            std::uint64_t result;
+            std::memcpy(&result, data, sizeof(result));
+            return result;
+        }
+    };
+
+    /**
+        \brief A ring buffer for a large number of items that keeps older segments compressed in memory.
+
+        The newest hot_segment_count segments are stored uncompressed. When the back of the
+        ring buffer enters a new segment the segment that leaves the hot window is compressed
+        using codec_type. Reading an item of a compressed segment decompresses the segment into
+        a small cache of cache_segment_count segments. If the codec supports random access only
+        the block containing the item is decompressed.
+
+        Designed for long histories of trivially copyable items that are appended at the back
+        and removed at the front. Items of compressed segments are read only.
+        References to items of compressed segments are valid until another compressed segment is
+        read, so even const access is not thread safe.
+
+        This is not a segment table of basic_large_ring_buffer because the core hands out
+        mutable references to every stored item, which a compressed segment cannot provide.
+        Therefore the interface is reduced compared to large_ring_buffer:
+        - operator[], at() and front() are const, writing a compressed item would be lost.
+        - There is no extend_front()/push_front(), the front is usually compressed and would
+          have to be decompressed and compressed again for every item.
+        - There is no clear handler, trivially copyable items need no cleanup.
+        pop_back() is supported, it only releases segments the back leaves.
+    */
+    template <typename value_type, typename codec_type = simple_lz_codec>
+    class tiered_large_ring_buffer
+    {
+    public:
+        /**
+            \brief Constructs a ring buffer object.
+        */
+        tiered_large_ring_buffer() = default;
+
+        /**
+            \brief Constructs a ring buffer object and configures it's size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] hot_segment_count     The number of newest segments that are stored uncompressed, at least one.
+            \param[in] cache_segment_count   The number of decompressed segments cached for reading, at least one.
+
+            number_of_segments * segment_size can be used to compute the number of items that can be stored.
+        */
+        tiered_large_ring_buffer(size_t number_of_segments, size_t segment_size, size_t hot_segment_count = 2, size_t cache_segment_count = 2)
+        {
+            discard_and_change_configuration(number_of_segments, segment_size, hot_segment_count, cache_segment_count);
+        }
+
+        /**
+            \brief Destroyes all stored objects and configures the size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are allocated as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \param[in] hot_segment_count     The number of newest segments that are stored uncompressed, at least one.
+            \param[in] cache_segment_count   The number of decompressed segments cached for reading, at least one.
+        */
+        void discard_and_change_configuration(size_t number_of_segments, size_t segment_size, size_t hot_segment_count = 2, size_t cache_segment_count = 2)
+        {
+            static_assert(std::is_trivially_copyable<value_type>::value, "tiered_large_ring_buffer requires a trivially copyable value_type.");
+            m_segments.clear();
+            m_cache.clear();
+            m_block_segment_index = no_segment;
+            m_start_index = 0;
+            m_size = 0;
+            m_max_size = 0;
+            m_segment_size = 0;
+            if (number_of_segments == 0 || segment_size == 0)
+            {
+                //nothing to do here; usable size will be zero
+            }
+            else
+            {
+                m_segment_size = segment_size;
+                m_segments.resize(number_of_segments);
+                m_max_size = number_of_segments * segment_size;
+                m_hot_segment_count = hot_segment_count ? hot_segment_count : 1;
+                m_cache.resize(cache_segment_count ? cache_segment_count : 1);
+            }
+        }
+
+        /**
+            \brief Removes all items and frees the memory of all segments.
+        */
+        void clear()
+        {
+            for (size_t i = 0; i < m_segments.size(); ++i)
+            {
+                release_segment(i);
+            }
+            m_start_index = 0;
+            m_size = 0;
+        }
+
+        /**
+            \brief Returns the number of items currently stored in the ring buffer.
+            \return The number of items currently stored in the ring buffer.
+        */
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        /**
+            \brief Returns true if no items are currently stored in the ring buffer.
+            \return True if no items are currently stored in the ring buffer.
+        */
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        /**
+            \brief Returns true if the maximum configured number of items are currently stored in the ring buffer.
+            \return True if the maximum configured number of items are currently stored in the ring buffer.
+        */
+        bool full() const
+        {
+            return m_max_size != 0 && m_size == m_max_size;
+        }
+
+        /**
+            \brief Returns the maximum configured number of items that can be stored in the ring buffer.
+            \return The maximum configured number of items that can be stored in the ring buffer.
+        */
+        size_t get_max_size() const
+        {
+            return m_max_size;
+        }
+
+        /**
+            \brief Returns the size of a segment.
+            \return The size of a segment.
+        */
+        size_t get_segment_size() const
+        {
+            return m_segment_size;
+        }
+
+        /**
+            \brief Returns the count of segments configured.
+            \return The count of segments configured.
+        */
+        size_t get_segment_count() const
+        {
+            return m_segments.size();
+        }
+
+        /**
+            \brief Returns the count of segments that are allocated, compressed or not.
+            \return The count of segments that are allocated.
+        */
+        size_t get_used_segments() const
+        {
+            size_t result = 0;
+            for (const auto& segment : m_segments)
+            {
+                if (!segment.items.empty() || !segment.compressed.empty())
+                {
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        /**
+            \brief Returns the count of segments that are stored uncompressed.
+            \return The count of segments that are stored uncompressed.
+        */
+        size_t get_hot_segments() const
+        {
+            size_t result = 0;
+            for (const auto& segment : m_segments)
+            {
+                if (!segment.items.empty())
+                {
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        /**
+            \brief Returns the number of bytes used by the segments including the cache.
+            \return The number of bytes used by the segments including the cache.
+        */
+        size_t get_memory_usage() const
+        {
+            size_t result = 0;
+            for (const auto& segment : m_segments)
+            {
+                result += segment.items.capacity() * sizeof(value_type) + segment.compressed.capacity();
+            }
+            for (const auto& entry : m_cache)
+            {
+                result += entry.items.capacity() * sizeof(value_type);
+            }
+            result += m_block_items.capacity() * sizeof(value_type);
+            return result;
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+        */
+        const value_type& operator[](size_t index) const
+        {
+            return get_item(to_internal_index(index));
+        }
+
+        /**
+            \brief Returns a reference to the item stored at the given index.
+            \param[in] index    The index of the item in the ring buffer.
+            \return The item in the ring buffer at the given index.
+            Throws an exception if the index is out of bounds.
+        */
+        const value_type& at(size_t index) const
+        {
+            if (index >= size())
+            {
+                throw std::range_error("Ringbuffer index out of bounds.");
+            }
+            return get_item(to_internal_index(index));
+        }
+
+        /**
+            \brief Returns the item at the front of the ring buffer.
+            \return The item at the front of the ring buffer.
+        */
+        const value_type& front() const
+        {
+            assert(!empty());
+            return get_item(m_start_index);
+        }
+
+        /**
+            \brief Returns the item at the back of the ring buffer.
+            \return The item at the back of the ring buffer.
+        */
+        const value_type& back() const
+        {
+            assert(!empty());
+            return get_item(to_internal_index(m_size - 1));
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+                   Overwrites an item at the front if the ring buffer is full.
+            \return The last item in the ring buffer, delivers a cached value or a newly created one.
+        */
+        value_type& extend_back()
+        {
+            assert(m_max_size);
+            if (full())
+            {
+                pop_front();
+            }
+            const size_t internal_index = to_internal_index(m_size);
+            const size_t segment_index = internal_index / m_segment_size;
+            make_hot(segment_index);
+            if (internal_index % m_segment_size == 0)
+            {
+                //entered a new segment, the segment leaving the hot window is compressed
+                if (m_hot_segment_count < m_segments.size())
+                {
+                    size_t cold_segment_index = segment_index + m_segments.size() - m_hot_segment_count;
+                    if (cold_segment_index >= m_segments.size())
+                    {
+                        cold_segment_index -= m_segments.size();
+                    }
+                    compress_segment(cold_segment_index);
+                }
+            }
+            ++m_size;
+            return m_segments[segment_index].items[internal_index % m_segment_size];
+        }
+
+        /**
+            \brief Adds an item at the back of the ring buffer.
+                   Overwrites an item at the front if the ring buffer is full.
+            \param[in] item     The item to add.
+        */
+        void push_back(const value_type& item)
+        {
+            extend_back() = item;
+        }
+
+        /**
+            \brief Removes an item at the front of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_front()
+        {
+            assert(!empty());
+            const size_t segment_index = m_start_index / m_segment_size;
+            ++m_start_index;
+            if (m_start_index == m_max_size)
+            {
+                m_start_index = 0;
+            }
+            --m_size;
+            if (m_start_index % m_segment_size == 0)
+            {
+                //left the segment, free it unless the back of the ring buffer wrapped into it
+                if (m_size == 0 || to_internal_index(m_size - 1) / m_segment_size != segment_index)
+                {
+                    release_segment(segment_index);
+                }
+            }
+        }
+
+        /**
+            \brief Removes an item at the back of the ring buffer.
+            Results in undefined behavior if the ring buffer is empty() (same as with standard C++ library containers)
+        */
+        void pop_back()
+        {
+            assert(!empty());
+            const size_t internal_index = to_internal_index(m_size - 1);
+            --m_size;
+            if (internal_index % m_segment_size == 0)
+            {
+                //left the segment, free it unless the front of the ring buffer is in it
+                const size_t segment_index = internal_index / m_segment_size;
+                if (m_size == 0 || m_start_index / m_segment_size != segment_index)
+                {
+                    release_segment(segment_index);
+                }
+            }
+        }
+
+    private:
+        struct segment
+        {
+            std::vector<value_type> items; // uncompressed items, empty if not hot
+            std::vector<unsigned char> compressed; // compressed items, empty if hot or not allocated
+        };
+
+        struct cache_entry
+        {
+            size_t segment_index = no_segment;
+            size_t last_use = 0;
+            std::vector<value_type> items;
+        };
+
+        static const size_t no_segment = static_cast<size_t>(-1);
+
+        size_t to_internal_index(size_t index) const
+        {
+            size_t internal_index = m_start_index + index;
+            if (internal_index >= m_max_size)
+            {
+                internal_index -= m_max_size;
+            }
+            return internal_index;
+        }
+
+        const value_type& get_item(size_t internal_index) const
+        {
+            const size_t segment_index = internal_index / m_segment_size;
+            const segment& current = m_segments[segment_index];
+            if (!current.items.empty())
+            {
+                return current.items[internal_index % m_segment_size];
+            }
+            return get_cold_item(segment_index, internal_index % m_segment_size, std::integral_constant<bool, codec_type::supports_random_access>());
+        }
+
+        const value_type& get_cold_item(size_t segment_index, size_t item_index, std::false_type /*supports_random_access*/) const
+        {
+            return get_cached_items(segment_index)[item_index];
+        }
+
+        const value_type& get_cold_item(size_t segment_index, size_t item_index, std::true_type /*supports_random_access*/) const
+        {
+            const size_t block_index = item_index / codec_type::block_size;
+            if (m_block_segment_index != segment_index || m_block_index != block_index)
+            {
+                const segment& current = m_segments[segment_index];
+                const size_t first = block_index * codec_type::block_size;
+                const size_t count = (m_segment_size - first < codec_type::block_size) ? m_segment_size - first : codec_type::block_size;
+                m_block_segment_index = no_segment;
+                m_block_items.resize(codec_type::block_size);
+                codec_type::decompress_block(current.compressed.data(), current.compressed.size(), block_index, m_block_items.data(), count);
+                m_block_segment_index = segment_index;
+                m_block_index = block_index;
+            }
+            return m_block_items[item_index % codec_type::block_size];
+        }
+
+        const std::vector<value_type>& get_cached_items(size_t segment_index) const
+        {
+            ++m_cache_use;
+            cache_entry* least_recently_used = &m_cache.front();
+            for (auto& entry : m_cache)
+            {
+                if (entry.segment_index == segment_index)
+                {
+                    entry.last_use = m_cache_use;
+                    return entry.items;
+                }
+                if (entry.last_use < least_recently_used->last_use)
+                {
+                    least_recently_used = &entry;
+                }
+            }
+
+            const segment& current = m_segments[segment_index];
+            least_recently_used->segment_index = no_segment;
+            least_recently_used->items.resize(m_segment_size);
+            codec_type::decompress(current.compressed.data(), current.compressed.size(), least_recently_used->items.data(), m_segment_size);
+            least_recently_used->segment_index = segment_index;
+            least_recently_used->last_use = m_cache_use;
+            return least_recently_used->items;
+        }
+
+        void invalidate_cache(size_t segment_index)
+        {
+            if (m_block_segment_index == segment_index)
+            {
+                m_block_segment_index = no_segment;
+            }
+            for (auto& entry : m_cache)
+            {
+                if (entry.segment_index == segment_index)
+                {
+                    entry.segment_index = no_segment;
+                    entry.last_use = 0;
+                }
+            }
+        }
+
+        void make_hot(size_t segment_index)
+        {
+            segment& current = m_segments[segment_index];
+            if (current.items.empty())
+            {
+                current.items.resize(m_segment_size);
+                if (!current.compressed.empty())
+                {
+                    codec_type::decompress(current.compressed.data(), current.compressed.size(), current.items.data(), m_segment_size);
+                    std::vector<unsigned char> temp;
+                    current.compressed.swap(temp);
+                    invalidate_cache(segment_index);
+                }
+            }
+        }
+
+        void compress_segment(size_t segment_index)
+        {
+            segment& current = m_segments[segment_index];
+            if (!current.items.empty())
+            {
+                codec_type::compress(current.items.data(), m_segment_size, current.compressed);
+                current.compressed.shrink_to_fit();
+                std::vector<value_type> temp;
+                current.items.swap(temp);
+            }
+        }
+
+        void release_segment(size_t segment_index)
+        {
+            //completely remove the segment and free the memory
+            segment temp;
+            std::swap(m_segments[segment_index], temp);
+            invalidate_cache(segment_index);
+        }
+
+        std::vector<segment> m_segments;
+        mutable std::vector<cache_entry> m_cache;
+        mutable size_t m_cache_use = 0;
+        mutable std::vector<value_type> m_block_items; // decompressed block if the codec supports random access
+        mutable size_t m_block_segment_index = no_segment;
+        mutable size_t m_block_index = 0;
+        size_t m_start_index = 0;
+        size_t m_size = 0;
+        size_t m_segment_size = 0;
+        size_t m_max_size = 0;
+        size_t m_hot_segment_count = 1;
+    };
+}
@@ -0,0 +1,406 @@
+// cpplargeringbuffer - A simple C++ large ring buffer implementation
+// Link: https://github.com/squeakycode/cpplargeringbuffer
+// Version: 1.0.0
+// Minimum required C++ Standard: C++11
+// License: BSD 3-Clause License
+// 
+// Copyright (c) 2024, Andreas Gau
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+\file
+\brief Contains a large ring buffer that stores all segments in one reserved range of virtual memory
+*/
+#pragma once
+#include "cpplargeringbuffer.hpp"
+#include "detail/virtual_memory.hpp"
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace cpplargeringbuffer
+{
+    /**
+        \brief A segment table that reserves the address space for all segments at once.
+
+        Segments are committed and decommitted in place, so all items are stored contiguously
+        starting at a single base pointer and an item is accessed as base + internal index.
+        Memory pages shared by adjacent segments are only decommitted if both segments are unused.
+    */
+    template <typename value_type>
+    class virtual_memory_segment_table
+    {
+    public:
+        virtual_memory_segment_table() = default;
+        virtual_memory_segment_table(const virtual_memory_segment_table&) = delete;
+        virtual_memory_segment_table& operator=(const virtual_memory_segment_table&) = delete;
+
+        /**
+            \brief Destroys all items and releases the address space.
+        */
+        ~virtual_memory_segment_table()
+        {
+            configure(0, 0);
+        }
+
+        /**
+            \brief Returns the size of a segment.
+            \return The size of a segment.
+        */
+        size_t get_segment_size() const
+        {
+            return m_segment_size;
+        }
+
+        /**
+            \brief Returns the count of segments configured.
+            \return The count of segments configured.
+        */
+        size_t get_segment_count() const
+        {
+            return m_allocated.size();
+        }
+
+        /**
+            \brief Returns the maximum configured number of items that can be stored.
+            \return The maximum configured number of items that can be stored.
+        */
+        size_t get_max_size() const
+        {
+            return m_max_size;
+        }
+
+        /**
+            \brief Returns true if the segment at the given index is allocated.
+            \param[in] segment_index    The index of the segment.
+            \return True if the segment at the given index is allocated.
+        */
+        bool is_allocated(size_t segment_index) const
+        {
+            return m_allocated[segment_index] != 0;
+        }
+
+        /**
+            \brief Commits the memory of the segment at the given index and constructs its items.
+            \param[in] segment_index    The index of the segment.
+        */
+        void allocate(size_t segment_index)
+        {
+            value_type* first = m_base + segment_index * m_segment_size;
+            const size_t page_start = round_down(reinterpret_cast<size_t>(first));
+            const size_t page_end = round_up(reinterpret_cast<size_t>(first + m_segment_size));
+            virtual_memory::commit(reinterpret_cast<void*>(page_start), page_end - page_start);
+
+            size_t constructed = 0;
+            try
+            {
+                for (; constructed < m_segment_size; ++constructed)
+                {
+                    ::new (static_cast<void*>(first + constructed)) value_type();
+                }
+            }
+            catch (...)
+            {
+                destroy(first, constructed);
+                decommit_unused_pages(first);
+                throw;
+            }
+            m_allocated[segment_index] = 1;
+        }
+
+        /**
+            \brief Destroys the items of the segment at the given index and decommits its memory.
+            \param[in] segment_index    The index of the segment.
+        */
+        void release(size_t segment_index)
+        {
+            if (!m_allocated[segment_index])
+            {
+                return;
+            }
+            value_type* first = m_base + segment_index * m_segment_size;
+            destroy(first, m_segment_size);
+            m_allocated[segment_index] = 0;
+            decommit_unused_pages(first);
+        }
+
+        /**
+            \brief Segments are stored in place and are released immediately.
+            \param[in] segment_index    The index of the segment.
+        */
+        void retire(size_t segment_index)
+        {
+            release(segment_index);
+        }
+
+        /**
+            \brief Segments are stored in place and are not handed over.
+            \return False.
+        */
+        bool hand_over(size_t)
+        {
+            return false;
+        }
+
+        /**
+            \brief Segments are never retired, nothing to reserve.
+        */
+        void reserve_retired()
+        {
+        }
+
+        /**
+            \brief Segments are never retired.
+            \return False.
+        */
+        bool reuse_retired(size_t)
+        {
+            return false;
+        }
+
+        /**
+            \brief Segments are never retired.
+            \return 0.
+        */
+        size_t reclaim()
+        {
+            return 0;
+        }
+
+        /**
+            \brief Segments are never retired.
+            \return 0.
+        */
+        size_t get_retired_count() const
+        {
+            return 0;
+        }
+
+        /**
+            \brief Segments are stored in place and cannot be moved.
+            \return False.
+        */
+        bool move(size_t, size_t)
+        {
+            return false;
+        }
+
+        /**
+            \brief Returns the item at the given index, the segment of the item must be allocated.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The item at the given index.
+        */
+        value_type& get_item(size_t internal_index)
+        {
+            return m_base[internal_index];
+        }
+
+        /**
+            \brief Returns the item at the given index, the segment of the item must be allocated.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The item at the given index.
+        */
+        const value_type& get_item(size_t internal_index) const
+        {
+            return m_base[internal_index];
+        }
+
+        /**
+            \brief Returns the number of items stored contiguously in memory starting at the given index.
+            \param[in] internal_index   The index of the item counted from the first segment.
+            \return The number of items up to the end of the reserved range.
+        */
+        size_t get_contiguous_size(size_t internal_index) const
+        {
+            return m_max_size - internal_index;
+        }
+
+        /**
+            \brief Returns the first item of the first segment.
+            \return The first item of the first segment.
+        */
+        value_type* data()
+        {
+            return m_base;
+        }
+
+        /**
+            \brief Destroyes all segments, releases the address space and reserves a new one.
+            \param[in] number_of_segments    The number of segments.
+            \param[in] segment_size          The size of a segment in number of items stored.
+            \return True, any configuration can be applied.
+            Throws std::range_error if the size of the address space cannot be represented.
+        */
+        bool configure(size_t number_of_segments, size_t segment_size)
+        {
+            for (size_t i = 0; i < m_allocated.size(); ++i)
+            {
+                release(i);
+            }
+            if (m_base)
+            {
+                virtual_memory::release(m_base, m_reserved_size);
+            }
+            m_base = nullptr;
+            m_reserved_size = 0;
+            m_allocated.clear();
+            m_max_size = 0;
+            m_segment_size = 0;
+            if (number_of_segments == 0 || segment_size == 0)
+            {
+                //nothing to do here; usable size will be zero
+            }
+            else
+            {
+                m_page_size = virtual_memory::get_page_size();
+                if (number_of_segments > (std::numeric_limits<size_t>::max() - m_page_size) / sizeof(value_type) / segment_size)
+                {
+                    throw std::range_error("Ringbuffer size too large.");
+                }
+                m_reserved_size = round_up(number_of_segments * segment_size * sizeof(value_type));
+                m_base = static_cast<value_type*>(virtual_memory::reserve(m_reserved_size));
+                m_segment_size = segment_size;
+                m_allocated.resize(number_of_segments);
+                m_max_size = number_of_segments * segment_size;
+            }
+            return true;
+        }
+
+    private:
+        static void destroy(value_type* first, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                first[i].~value_type();
+            }
+        }
+
+        bool is_page_used(size_t page_start) const
+        {
+            const size_t segment_bytes = m_segment_size * sizeof(value_type);
+            const size_t base = reinterpret_cast<size_t>(m_base);
+            const size_t first_segment = (page_start > base) ? (page_start - base) / segment_bytes : 0;
+            size_t last_segment = (page_start + m_page_size - 1 - base) / segment_bytes;
+            if (last_segment >= m_allocated.size())
+            {
+                last_segment = m_allocated.size() - 1;
+            }
+            for (size_t i = first_segment; i <= last_segment; ++i)
+            {
+                if (m_allocated[i])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void decommit_unused_pages(value_type* first)
+        {
+            size_t page_start = round_down(reinterpret_cast<size_t>(first));
+            size_t page_end = round_up(reinterpret_cast<size_t>(first + m_segment_size));
+            //keep pages that are shared with allocated segments
+            if (is_page_used(page_start))
+            {
+                page_start += m_page_size;
+            }
+            if (page_start < page_end && is_page_used(page_end - m_page_size))
+            {
+                page_end -= m_page_size;
+            }
+            if (page_start < page_end)
+            {
+                virtual_memory::decommit(reinterpret_cast<void*>(page_start), page_end - page_start);
+            }
+        }
+
+        size_t round_down(size_t value) const
+        {
+            return value - value % m_page_size;
+        }
+
+        size_t round_up(size_t value) const
+        {
+            return round_down(value + m_page_size - 1);
+        }
+
+        value_type* m_base = nullptr;
+        size_t m_reserved_size = 0;
+        size_t m_page_size = 1;
+        std::vector<unsigned char> m_allocated;
+        size_t m_segment_size = 0;
+        size_t m_max_size = 0;
+    };
+
+    /**
+        \brief A ring buffer implementation for a large number of items stored in one reserved range of virtual memory.
+
+         Behaves like large_ring_buffer, but instead of allocating each segment on the heap the
+         address space for all segments is reserved once. Segments are committed when they are
+         needed and decommitted when they are not used anymore. Accessing an item does not need
+         to load a segment table, and items that do not wrap around the end of the reserved range
+         are contiguous in memory.
+    */
+    template <typename value_type, typename clear_handler_type = noop_clear_handler<value_type> >
+    class virtual_memory_large_ring_buffer : public basic_large_ring_buffer<value_type, clear_handler_type, virtual_memory_segment_table<value_type> >
+    {
+    public:
+        /**
+            \brief Constructs a ring buffer object.
+        */
+        virtual_memory_large_ring_buffer() = default;
+
+        /**
+            \brief Constructs a ring buffer object and configures it's size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are committed as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+                                             All items are constructed and destroyed at the same time when needed.
+
+            number_of_segments * segment_size can be used to compute the number of items that can be stored.
+        */
+        virtual_memory_large_ring_buffer(size_t number_of_segments, size_t segment_size)
+        {
+            discard_and_change_configuration(number_of_segments, segment_size);
+        }
+
+        /**
+            \brief Destroyes all stored objects and configures the size parameters.
+            \param[in] number_of_segments    The ring buffer is structured in to number_of_segments that are committed as the ring buffer is filled.
+            \param[in] segment_size          The size of a segment in number of items stored.
+                                             All items are constructed and destroyed at the same time when needed.
+            \post
+            - All items stored are destroyed.
+            - Clear is not called on the items.
+            - The new configuration is applied.
+        */
+        void discard_and_change_configuration(size_t number_of_segments, size_t segment_size)
+        {
+            this->discard_and_configure(number_of_segments, segment_size);
+        }
+    };
+}
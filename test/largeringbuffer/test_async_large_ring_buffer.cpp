@@ -0,0 +1,248 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/async_large_ring_buffer.hpp>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <vector>
+
+namespace
+{
+    // a coroutine that starts immediately and is not awaited by anyone
+    struct detached_task
+    {
+        struct promise_type
+        {
+            detached_task get_return_object()
+            {
+                return detached_task();
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return std::suspend_never();
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return std::suspend_never();
+            }
+
+            void return_void()
+            {
+            }
+
+            void unhandled_exception()
+            {
+                std::terminate();
+            }
+        };
+    };
+
+    // a coroutine that starts immediately and is destroyed by its owner
+    struct owned_task
+    {
+        struct promise_type
+        {
+            owned_task get_return_object()
+            {
+                return owned_task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return std::suspend_never();
+            }
+
+            std::suspend_always final_suspend() noexcept
+            {
+                return std::suspend_always();
+            }
+
+            void return_void()
+            {
+            }
+
+            void unhandled_exception()
+            {
+                std::terminate();
+            }
+        };
+
+        explicit owned_task(std::coroutine_handle<promise_type> handle)
+            : m_handle(handle)
+        {
+        }
+
+        owned_task(const owned_task&) = delete;
+        owned_task& operator=(const owned_task&) = delete;
+
+        ~owned_task()
+        {
+            m_handle.destroy();
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    owned_task consume_owned(cpplargeringbuffer::async_large_ring_buffer<int>& ring_buffer, std::vector<int>& received)
+    {
+        received.push_back(co_await ring_buffer.next());
+        std::vector<int> batch = co_await ring_buffer.next_batch(2);
+        received.insert(received.end(), batch.begin(), batch.end());
+    }
+
+    detached_task consume(cpplargeringbuffer::async_large_ring_buffer<int>& ring_buffer, int count, std::vector<int>& received)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            received.push_back(co_await ring_buffer.next());
+        }
+    }
+
+    detached_task consume_batches(cpplargeringbuffer::async_large_ring_buffer<int>& ring_buffer, size_t max_count, std::vector<std::vector<int> >& received)
+    {
+        for (;;)
+        {
+            std::vector<int> batch = co_await ring_buffer.next_batch(max_count);
+            const bool last = batch.back() < 0;
+            received.push_back(std::move(batch));
+            if (last)
+            {
+                break;
+            }
+        }
+    }
+}
+
+TEST_CASE("async_large_ring_buffer resumes in producer", "[async_large_ring_buffer]")
+{
+    cpplargeringbuffer::async_large_ring_buffer<int> testee(4, 10);
+    std::vector<int> received;
+
+    testee.push_back(1);
+    consume(testee, 4, received);
+    // the available item is taken without suspending
+    REQUIRE(received.size() == 1);
+    CHECK(received[0] == 1);
+    CHECK(testee.empty());
+
+    testee.push_back(2);
+    CHECK(received.size() == 2);
+    testee.push_back(3);
+    testee.push_back(4);
+    CHECK(received == std::vector<int>({ 1, 2, 3, 4 }));
+
+    testee.push_back(5);
+    CHECK(testee.size() == 1);
+    int item = 0;
+    CHECK(testee.try_pop_front(item));
+    CHECK(item == 5);
+}
+
+TEST_CASE("async_large_ring_buffer executor", "[async_large_ring_buffer]")
+{
+    std::deque<std::coroutine_handle<> > event_loop;
+    cpplargeringbuffer::async_large_ring_buffer<int> testee(4, 10, [&event_loop](std::coroutine_handle<> handle)
+    {
+        event_loop.push_back(handle);
+    });
+    std::vector<int> first;
+    std::vector<int> second;
+
+    consume(testee, 2, first);
+    consume(testee, 2, second);
+    CHECK(first.empty());
+    CHECK(second.empty());
+
+    // items are handed to the waiting coroutines in order, resuming is left to the event loop
+    testee.push_back(10);
+    testee.push_back(20);
+    CHECK(event_loop.size() == 2);
+    CHECK(first.empty());
+    while (!event_loop.empty())
+    {
+        std::coroutine_handle<> handle = event_loop.front();
+        event_loop.pop_front();
+        handle.resume();
+    }
+    CHECK(first == std::vector<int>({ 10 }));
+    CHECK(second == std::vector<int>({ 20 }));
+
+    testee.modify([](cpplargeringbuffer::large_ring_buffer<int>& ring_buffer)
+    {
+        ring_buffer.push_back(30);
+        ring_buffer.push_back(40);
+        ring_buffer.push_back(50);
+    });
+    CHECK(event_loop.size() == 2);
+    while (!event_loop.empty())
+    {
+        std::coroutine_handle<> handle = event_loop.front();
+        event_loop.pop_front();
+        handle.resume();
+    }
+    CHECK(first == std::vector<int>({ 10, 30 }));
+    CHECK(second == std::vector<int>({ 20, 40 }));
+    CHECK(testee.size() == 1);
+}
+
+TEST_CASE("async_large_ring_buffer batches", "[async_large_ring_buffer]")
+{
+    cpplargeringbuffer::async_large_ring_buffer<int> testee(4, 10);
+    std::vector<std::vector<int> > received;
+
+    testee.modify([](cpplargeringbuffer::large_ring_buffer<int>& ring_buffer)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            ring_buffer.push_back(i);
+        }
+    });
+    consume_batches(testee, 3, received);
+    REQUIRE(received.size() == 2);
+    CHECK(received[0] == std::vector<int>({ 0, 1, 2 }));
+    CHECK(received[1] == std::vector<int>({ 3, 4 }));
+
+    testee.push_back(5);
+    testee.push_back(-1);
+    REQUIRE(received.size() == 4);
+    CHECK(received[2] == std::vector<int>({ 5 }));
+    CHECK(received[3] == std::vector<int>({ -1 }));
+    CHECK(testee.empty());
+}
+
+TEST_CASE("async_large_ring_buffer destroyed waiters", "[async_large_ring_buffer]")
+{
+    cpplargeringbuffer::async_large_ring_buffer<int> testee(4, 10);
+    std::vector<int> received;
+    {
+        owned_task cancelled = consume_owned(testee, received);
+    }
+    // the destroyed coroutine does not take the item
+    testee.push_back(1);
+    CHECK(testee.size() == 1);
+    CHECK(received.empty());
+
+    {
+        owned_task cancelled = consume_owned(testee, received);
+        CHECK(received == std::vector<int>({ 1 }));
+        // suspended in next_batch
+        CHECK(testee.empty());
+    }
+    std::vector<int> other;
+    consume(testee, 1, other);
+    testee.push_back(2);
+    CHECK(other == std::vector<int>({ 2 }));
+    CHECK(received == std::vector<int>({ 1 }));
+
+    {
+        // destroying a completed coroutine does not touch the ring buffer
+        owned_task completed = consume_owned(testee, received);
+        testee.push_back(3);
+        testee.push_back(4);
+        testee.push_back(5);
+        CHECK(received == std::vector<int>({ 1, 3, 4 }));
+    }
+    CHECK(testee.size() == 1);
+}
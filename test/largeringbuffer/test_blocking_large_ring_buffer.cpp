@@ -0,0 +1,137 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/blocking_large_ring_buffer.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE("blocking_large_ring_buffer timeouts", "[blocking_large_ring_buffer]")
+{
+    cpplargeringbuffer::blocking_large_ring_buffer<int> testee(4, 10);
+    int item = 0;
+
+    CHECK(testee.empty());
+    CHECK(!testee.try_pop_front(item));
+    const auto start = std::chrono::steady_clock::now();
+    CHECK(!testee.wait_pop_front(item, std::chrono::milliseconds(20)));
+    CHECK(!testee.wait_for_size(1, std::chrono::milliseconds(20)));
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(40));
+
+    testee.push_back(7);
+    CHECK(testee.wait_for_size(1, std::chrono::milliseconds(0)));
+    CHECK(!testee.wait_for_size(2, std::chrono::milliseconds(0)));
+    // limited to the maximum size
+    CHECK(!testee.wait_for_size(1000, std::chrono::milliseconds(0)));
+    CHECK(testee.wait_pop_front(item, std::chrono::milliseconds(0)));
+    CHECK(item == 7);
+    CHECK(testee.empty());
+
+    cpplargeringbuffer::blocking_large_ring_buffer<int> unconfigured;
+    CHECK(!unconfigured.wait_pop_front(item, std::chrono::milliseconds(1)));
+}
+
+TEST_CASE("blocking_large_ring_buffer unlimited timeouts", "[blocking_large_ring_buffer]")
+{
+    cpplargeringbuffer::blocking_large_ring_buffer<int> testee(4, 10);
+    std::thread producer([&testee]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        testee.push_back(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        testee.push_back(2);
+    });
+
+    int item = 0;
+    CHECK(testee.wait_pop_front(item, std::chrono::nanoseconds::max()));
+    CHECK(item == 1);
+    CHECK(testee.wait_for_size(1, std::chrono::hours::max()));
+    producer.join();
+}
+
+TEST_CASE("blocking_large_ring_buffer producer and consumer", "[blocking_large_ring_buffer]")
+{
+    cpplargeringbuffer::blocking_large_ring_buffer<int> testee(100, 100);
+    const int item_count = 20000;
+
+    std::vector<int> received;
+    std::thread consumer([&testee, &received, item_count]()
+    {
+        int item = 0;
+        while (static_cast<int>(received.size()) < item_count && testee.wait_pop_front(item, std::chrono::seconds(10)))
+        {
+            received.push_back(item);
+        }
+    });
+
+    for (int i = 0; i < item_count; ++i)
+    {
+        if (i % 1000 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        testee.push_back(i);
+    }
+    consumer.join();
+
+    REQUIRE(received.size() == static_cast<size_t>(item_count));
+    for (int i = 0; i < item_count; ++i)
+    {
+        REQUIRE(received[static_cast<size_t>(i)] == i);
+    }
+}
+
+TEST_CASE("blocking_large_ring_buffer wait for batch", "[blocking_large_ring_buffer]")
+{
+    cpplargeringbuffer::blocking_large_ring_buffer<int> testee(10, 10);
+
+    std::thread producer([&testee]()
+    {
+        for (int batch = 0; batch < 5; ++batch)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            testee.modify([batch](cpplargeringbuffer::large_ring_buffer<int>& ring_buffer)
+            {
+                for (int i = 0; i < 10; ++i)
+                {
+                    ring_buffer.push_back(batch * 10 + i);
+                }
+            });
+        }
+    });
+
+    CHECK(testee.wait_for_size(50, std::chrono::seconds(10)));
+    producer.join();
+    testee.access([](cpplargeringbuffer::large_ring_buffer<int>& ring_buffer)
+    {
+        CHECK(ring_buffer.size() == 50);
+        CHECK(ring_buffer.back() == 49);
+        ring_buffer.release_front(50);
+    });
+    CHECK(testee.empty());
+}
+
+TEST_CASE("blocking_large_ring_buffer waiters for different sizes", "[blocking_large_ring_buffer]")
+{
+    cpplargeringbuffer::blocking_large_ring_buffer<int> testee(10, 10);
+
+    bool small_result = false;
+    bool large_result = false;
+    std::thread small_waiter([&testee, &small_result]()
+    {
+        small_result = testee.wait_for_size(5, std::chrono::seconds(10));
+    });
+    std::thread large_waiter([&testee, &large_result]()
+    {
+        large_result = testee.wait_for_size(30, std::chrono::seconds(10));
+    });
+
+    for (int i = 0; i < 30; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        testee.push_back(i);
+    }
+    small_waiter.join();
+    large_waiter.join();
+    CHECK(small_result);
+    CHECK(large_result);
+    CHECK(testee.size() == 30);
+}
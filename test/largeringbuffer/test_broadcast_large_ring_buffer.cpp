@@ -0,0 +1,178 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/broadcast_large_ring_buffer.hpp>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef cpplargeringbuffer::broadcast_large_ring_buffer<int> broadcast_type;
+}
+
+TEST_CASE("broadcast_large_ring_buffer independent cursors", "[broadcast_large_ring_buffer]")
+{
+    broadcast_type testee(4, 5);
+    testee.push_back(-1);
+
+    const broadcast_type::consumer_id exporter = testee.add_consumer();
+    const broadcast_type::consumer_id ui = testee.add_consumer();
+    CHECK(testee.size() == 0);
+    CHECK(testee.get_available(exporter) == 0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(testee.push_back(i));
+    }
+    CHECK(testee.size() == 10);
+    CHECK(testee.get_available(exporter) == 10);
+
+    int item = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(testee.try_read(exporter, item));
+        CHECK(item == i);
+    }
+    CHECK(!testee.try_read(exporter, item));
+    // still needed by the ui consumer
+    CHECK(testee.size() == 10);
+
+    std::vector<int> read;
+    CHECK(testee.read(ui, 4, [&read](const int& value) { read.push_back(value); }) == 4);
+    CHECK(read == std::vector<int>({ 0, 1, 2, 3 }));
+    CHECK(testee.size() == 6);
+    CHECK(testee.get_available(ui) == 6);
+
+    const broadcast_type::consumer_id late = testee.add_consumer(true);
+    CHECK(testee.get_available(late) == 6);
+    REQUIRE(testee.try_read(late, item));
+    CHECK(item == 4);
+
+    testee.remove_consumer(ui);
+    CHECK(testee.get_available(ui) == 0);
+    CHECK(testee.size() == 5);
+    CHECK(!testee.is_dropped(ui));
+    CHECK_THROWS_AS(testee.get_available(42), std::range_error);
+}
+
+TEST_CASE("broadcast_large_ring_buffer reuses consumer slots", "[broadcast_large_ring_buffer]")
+{
+    broadcast_type testee(2, 3, broadcast_type::lag_policy::drop_slow_consumers);
+    const broadcast_type::consumer_id first = testee.add_consumer();
+    const broadcast_type::consumer_id slow = testee.add_consumer();
+    testee.remove_consumer(first);
+    CHECK(testee.get_available(first) == 0);
+
+    const broadcast_type::consumer_id second = testee.add_consumer();
+    CHECK(second != first);
+    CHECK((second & 0xffffffffu) == (first & 0xffffffffu));
+    CHECK_THROWS_AS(testee.get_available(first), std::range_error);
+    CHECK_THROWS_AS(testee.remove_consumer(first), std::range_error);
+
+    // dropped consumers keep their slot until they are removed
+    int item = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(testee.push_back(i));
+        REQUIRE(testee.try_read(second, item));
+    }
+    CHECK(testee.is_dropped(slow));
+    const broadcast_type::consumer_id third = testee.add_consumer();
+    CHECK(testee.is_dropped(slow));
+    testee.remove_consumer(slow);
+    const broadcast_type::consumer_id fourth = testee.add_consumer();
+    CHECK((fourth & 0xffffffffu) == (slow & 0xffffffffu));
+    CHECK_THROWS_AS(testee.is_dropped(slow), std::range_error);
+
+    REQUIRE(testee.push_back(10));
+    CHECK(testee.get_available(second) == 1);
+    CHECK(testee.get_available(third) == 1);
+    CHECK(testee.get_available(fourth) == 1);
+}
+
+TEST_CASE("broadcast_large_ring_buffer reject new items", "[broadcast_large_ring_buffer]")
+{
+    broadcast_type testee(2, 3);
+    const broadcast_type::consumer_id fast = testee.add_consumer();
+    const broadcast_type::consumer_id slow = testee.add_consumer();
+
+    int item = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        REQUIRE(testee.push_back(i));
+        REQUIRE(testee.try_read(fast, item));
+    }
+    CHECK(!testee.push_back(6));
+    REQUIRE(testee.try_read(slow, item));
+    CHECK(item == 0);
+    CHECK(testee.push_back(6));
+    CHECK(!testee.push_back(7));
+    CHECK(testee.get_available(fast) == 1);
+    CHECK(testee.get_available(slow) == 6);
+    CHECK(!testee.is_dropped(slow));
+}
+
+TEST_CASE("broadcast_large_ring_buffer drop slow consumers", "[broadcast_large_ring_buffer]")
+{
+    broadcast_type testee(2, 3, broadcast_type::lag_policy::drop_slow_consumers);
+    const broadcast_type::consumer_id fast = testee.add_consumer();
+    const broadcast_type::consumer_id slow = testee.add_consumer();
+
+    int item = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        REQUIRE(testee.push_back(i));
+        REQUIRE(testee.try_read(fast, item));
+        CHECK(item == i);
+    }
+    CHECK(testee.is_dropped(slow));
+    CHECK(!testee.is_dropped(fast));
+    CHECK(!testee.try_read(slow, item));
+    CHECK(testee.size() == 0);
+}
+
+TEST_CASE("broadcast_large_ring_buffer concurrent consumers", "[broadcast_large_ring_buffer]")
+{
+    broadcast_type testee(10, 100);
+    const int item_count = 20000;
+    std::vector<broadcast_type::consumer_id> ids;
+    for (int i = 0; i < 3; ++i)
+    {
+        ids.push_back(testee.add_consumer());
+    }
+
+    std::vector<std::vector<int> > received(ids.size());
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < ids.size(); ++c)
+    {
+        consumers.emplace_back([&testee, &received, &ids, c, item_count]()
+        {
+            while (static_cast<int>(received[c].size()) < item_count)
+            {
+                if (!testee.read(ids[c], 50, [&received, c](const int& value) { received[c].push_back(value); }))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int i = 0; i < item_count; ++i)
+    {
+        while (!testee.push_back(i))
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    for (const std::vector<int>& items : received)
+    {
+        REQUIRE(items.size() == static_cast<size_t>(item_count));
+        for (int i = 0; i < item_count; ++i)
+        {
+            REQUIRE(items[static_cast<size_t>(i)] == i);
+        }
+    }
+    CHECK(testee.size() == 0);
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/budget_large_ring_buffer.hpp>
+#include <string>
+
+namespace
+{
+    struct string_length
+    {
+        size_t operator()(const std::string& item) const
+        {
+            return item.size();
+        }
+    };
+
+    typedef cpplargeringbuffer::budget_large_ring_buffer<std::string, string_length> budget_type;
+}
+
+TEST_CASE("budget_large_ring_buffer evicts by bytes", "[budget_large_ring_buffer]")
+{
+    budget_type testee(10, 10, 100);
+    CHECK(testee.get_byte_budget() == 100);
+    CHECK(testee.get_used_bytes() == 0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        testee.push_back(std::string(10, static_cast<char>('a' + i)));
+    }
+    CHECK(testee.size() == 10);
+    CHECK(testee.get_used_bytes() == 100);
+
+    testee.push_back(std::string(25, 'x'));
+    CHECK(testee.size() == 8);
+    CHECK(testee.get_used_bytes() == 95);
+    CHECK(testee.front() == std::string(10, 'd'));
+    CHECK(testee.back() == std::string(25, 'x'));
+
+    testee.pop_back();
+    CHECK(testee.get_used_bytes() == 70);
+    testee.pop_front();
+    CHECK(testee.get_used_bytes() == 60);
+    CHECK(testee[0] == std::string(10, 'e'));
+    CHECK(testee.at(5) == std::string(10, 'j'));
+
+    CHECK_THROWS_AS(testee.push_back(std::string(101, 'y')), std::range_error);
+    CHECK(testee.size() == 6);
+
+    testee.set_byte_budget(35);
+    CHECK(testee.size() == 3);
+    CHECK(testee.get_used_bytes() == 30);
+    testee.clear();
+    CHECK(testee.empty());
+    CHECK(testee.get_used_bytes() == 0);
+}
+
+TEST_CASE("budget_large_ring_buffer evicts by count", "[budget_large_ring_buffer]")
+{
+    budget_type testee(2, 3, 1000);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        testee.push_back(std::string(static_cast<size_t>(i), 'z'));
+    }
+    CHECK(testee.size() == 6);
+    CHECK(testee.get_max_size() == 6);
+    CHECK(testee.get_used_bytes() == 4 + 5 + 6 + 7 + 8 + 9);
+    CHECK(testee.front().size() == 4);
+}
+
+namespace
+{
+    struct string_capacity
+    {
+        size_t operator()(const std::string& item) const
+        {
+            return sizeof(item) + item.capacity();
+        }
+    };
+
+    typedef cpplargeringbuffer::budget_large_ring_buffer<std::string, string_capacity> capacity_budget_type;
+
+    size_t stored_bytes(const capacity_budget_type& testee)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < testee.size(); ++i)
+        {
+            result += string_capacity()(testee[i]);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("budget_large_ring_buffer measures the stored items", "[budget_large_ring_buffer]")
+{
+    capacity_budget_type testee(2, 4, 4000);
+
+    // a large item leaves a slot with a large capacity behind
+    testee.push_back(std::string(1000, 'a'));
+    CHECK(testee.get_used_bytes() == stored_bytes(testee));
+    testee.pop_back();
+    CHECK(testee.get_used_bytes() == 0);
+
+    // the source capacity differs from the capacity of the stored copy
+    std::string reserved("small");
+    reserved.reserve(500);
+    for (int i = 0; i < 100; ++i)
+    {
+        testee.push_back(i % 3 ? reserved : std::string(static_cast<size_t>(i * 10), 'b'));
+        CHECK(testee.get_used_bytes() == stored_bytes(testee));
+        CHECK(testee.get_used_bytes() <= testee.get_byte_budget());
+        if (i % 7 == 0)
+        {
+            testee.pop_front();
+            CHECK(testee.get_used_bytes() == stored_bytes(testee));
+        }
+        if (i % 11 == 0 && !testee.empty())
+        {
+            testee.pop_back();
+            CHECK(testee.get_used_bytes() == stored_bytes(testee));
+        }
+    }
+    CHECK(testee.size() > 1);
+}
+
+TEST_CASE("swap_default_clear_handler frees memory", "[budget_large_ring_buffer]")
+{
+    std::string item(1000, 'a');
+    cpplargeringbuffer::swap_default_clear_handler<std::string>::clear(item);
+    CHECK(item.empty());
+    CHECK(item.capacity() < 1000);
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/huge_page_allocator.hpp>
+#include <cstdint>
+
+namespace
+{
+    typedef cpplargeringbuffer::huge_page_allocator<std::uint64_t> allocator_type;
+    typedef cpplargeringbuffer::large_ring_buffer<std::uint64_t, cpplargeringbuffer::noop_clear_handler<std::uint64_t>, allocator_type> ring_buffer_type;
+}
+
+TEST_CASE("huge_page_allocator large segments", "[huge_page_allocator]")
+{
+    // 4 MiB segments
+    const size_t segment_size = 512 * 1024;
+    ring_buffer_type testee(4, segment_size, allocator_type());
+    const std::shared_ptr<cpplargeringbuffer::huge_page_statistics> statistics = testee.get_allocator().get_statistics();
+    const size_t huge_page_size = allocator_type::get_huge_page_size();
+
+    for (std::uint64_t i = 0; i < 6 * segment_size; ++i)
+    {
+        testee.push_back(i);
+    }
+    REQUIRE(testee.full());
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        REQUIRE(testee[i] == i + 2 * segment_size);
+    }
+
+    if (huge_page_size)
+    {
+        CHECK(statistics->advised_huge_page_allocations == testee.get_used_segments());
+        CHECK(statistics->regular_allocations == 0);
+        CHECK(reinterpret_cast<std::uintptr_t>(&testee[0]) % huge_page_size == 0);
+    }
+    else
+    {
+        CHECK(statistics->advised_huge_page_allocations == 0);
+        CHECK(statistics->regular_allocations == testee.get_used_segments());
+    }
+
+    testee.discard_and_change_configuration(0, 0);
+    CHECK(statistics->advised_huge_page_allocations == 0);
+    CHECK(statistics->regular_allocations == 0);
+}
+
+TEST_CASE("huge_page_allocator small segments and numa node", "[huge_page_allocator]")
+{
+    ring_buffer_type testee(10, 100, allocator_type(0));
+    const std::shared_ptr<cpplargeringbuffer::huge_page_statistics> statistics = testee.get_allocator().get_statistics();
+
+    CHECK(testee.get_allocator().get_numa_node() == 0);
+    for (std::uint64_t i = 0; i < 2500; ++i)
+    {
+        testee.push_back(i);
+    }
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        REQUIRE(testee[i] == 1500 + i);
+    }
+    CHECK(statistics->advised_huge_page_allocations == 0);
+    CHECK(statistics->regular_allocations == testee.get_used_segments());
+}
+
+TEST_CASE("huge_page_allocator equality", "[huge_page_allocator]")
+{
+    const allocator_type first(1);
+    const allocator_type copy(first);
+    const cpplargeringbuffer::huge_page_allocator<char> rebound(first);
+    const allocator_type other(1);
+
+    CHECK(first == copy);
+    CHECK(first == rebound);
+    CHECK(first != other);
+    CHECK(rebound.get_statistics() == first.get_statistics());
+}
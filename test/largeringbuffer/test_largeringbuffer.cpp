@@ -1,7 +1,223 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include <catch2/catch.hpp>
 #include <cpplargeringbuffer/cpplargeringbuffer.hpp>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <deque>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    // size oscillates between 8 and 40 items, that is 4 segments of 8 items
+    size_t run_sawtooth(cpplargeringbuffer::large_ring_buffer<int>& testee, int rounds)
+    {
+        int value = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            testee.push_back(value++);
+        }
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (int i = 0; i < 32; ++i)
+            {
+                testee.push_back(value++);
+            }
+            for (int i = 0; i < 32; ++i)
+            {
+                REQUIRE(testee.front() == value - 40 + i);
+                testee.pop_front();
+            }
+        }
+        return testee.get_allocation_statistics().allocated_segments;
+    }
+
+    struct counted_item
+    {
+        static int live;
+        int value = 0;
+
+        counted_item()
+        {
+            ++live;
+        }
+
+        counted_item(const counted_item& other) : value(other.value)
+        {
+            ++live;
+        }
+
+        counted_item& operator=(const counted_item&) = default;
+
+        ~counted_item()
+        {
+            --live;
+        }
+    };
+
+    int counted_item::live = 0;
+
+    struct nonzero_item
+    {
+        int value = 42;
+    };
+
+    struct zero_item
+    {
+        int value;
+        double weight;
+    };
+
+    typedef int zero_item::* member_pointer;
+
+    struct counting_clear_handler
+    {
+        static int calls;
+
+        static void clear(int& v)
+        {
+            ++calls;
+            v = -1;
+        }
+    };
+
+    int counting_clear_handler::calls = 0;
+
+    struct clearable_item
+    {
+        std::string text;
+
+        void clear()
+        {
+            text.clear();
+        }
+
+        bool operator==(const clearable_item& other) const
+        {
+            return text == other.text;
+        }
+    };
+
+    template <typename value_type>
+    value_type make_item(int i)
+    {
+        return static_cast<value_type>(i);
+    }
+
+    template <>
+    std::string make_item<std::string>(int i)
+    {
+        return std::to_string(i);
+    }
+
+    template <>
+    nonzero_item make_item<nonzero_item>(int i)
+    {
+        nonzero_item result;
+        result.value = i;
+        return result;
+    }
+
+    template <>
+    clearable_item make_item<clearable_item>(int i)
+    {
+        clearable_item result;
+        result.text = std::to_string(i);
+        return result;
+    }
+
+    bool same_item(const nonzero_item& a, const nonzero_item& b)
+    {
+        return a.value == b.value;
+    }
+
+    template <typename value_type>
+    bool same_item(const value_type& a, const value_type& b)
+    {
+        return a == b;
+    }
+
+    // runs the same operations with the bulk and the item by item functions and compares the results
+    template <typename value_type, typename clear_handler_type>
+    void check_bulk_equivalence(const value_type& cleared)
+    {
+        cpplargeringbuffer::large_ring_buffer<value_type, clear_handler_type> bulk(5, 7);
+        cpplargeringbuffer::large_ring_buffer<value_type, clear_handler_type> single(5, 7);
+        std::mt19937 random(11);
+        int value = 0;
+        for (int round = 0; round < 400; ++round)
+        {
+            const unsigned int operation = random() % 4;
+            const size_t count = random() % 50;
+            if (operation < 2)
+            {
+                std::vector<value_type> items;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    items.push_back(make_item<value_type>(value++));
+                }
+                bulk.push_back(items.data(), items.size());
+                for (const value_type& item : items)
+                {
+                    single.push_back(item);
+                }
+            }
+            else if (operation == 2)
+            {
+                const size_t removed = count < single.size() ? count : single.size();
+                bulk.release_front(removed);
+                for (size_t i = 0; i < removed; ++i)
+                {
+                    single.pop_front();
+                }
+                if (removed && removed <= single.get_segment_size() && single.size() + removed == single.get_max_size())
+                {
+                    // the removed items are cached in front of the start and cleared, no segment was freed
+                    for (size_t i = 0; i < removed; ++i)
+                    {
+                        REQUIRE(same_item(bulk.extend_front(), cleared));
+                        REQUIRE(same_item(single.extend_front(), cleared));
+                    }
+                    bulk.release_front(removed);
+                    single.release_front(removed);
+                }
+            }
+            else
+            {
+                std::vector<value_type> copied(count);
+                const size_t copied_count = bulk.copy_front(copied.data(), count);
+                REQUIRE(copied_count == (count < single.size() ? count : single.size()));
+                for (size_t i = 0; i < copied_count; ++i)
+                {
+                    REQUIRE(same_item(copied[i], single[i]));
+                }
+            }
+            REQUIRE(bulk.size() == single.size());
+            REQUIRE(bulk.get_used_segments() == single.get_used_segments());
+            for (size_t i = 0; i < single.size(); ++i)
+            {
+                REQUIRE(same_item(bulk[i], single[i]));
+            }
+        }
+        bulk.clear();
+        REQUIRE(bulk.empty());
+        REQUIRE(bulk.get_used_segments() == 0);
+    }
+}
+
+namespace cpplargeringbuffer
+{
+    template <>
+    struct is_zero_initialized<zero_item> : std::true_type
+    {
+    };
+}
 
 TEST_CASE("large_ring_buffer defaults", "[large_ring_buffer]")
 {
@@ -595,3 +811,1064 @@ TEST_CASE("large_ring_buffer fill back 2", "[large_ring_buffer]")
     }
     checkValueRange(testee, testee.get_max_size() + testee.get_segment_size(), testee.get_max_size());
 }
+
+TEST_CASE("large_ring_buffer save and load", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<size_t> testee(5, 3);
+    const size_t max_value = 2 * testee.get_max_size() + 1;
+    for (size_t i = 0; i < max_value; ++i)
+    {
+        testee.push_back(i);
+    }
+    testee.pop_front();
+    testee.pop_front();
+    checkValueRange(testee, testee.get_max_size() + 3, testee.get_max_size() - 2);
+
+    std::stringstream stream;
+    testee.save(stream);
+
+    cpplargeringbuffer::large_ring_buffer<size_t> restored(1, 1);
+    restored.push_back(42);
+    restored.load(stream);
+    CHECK(restored.get_segment_count() == 5);
+    CHECK(restored.get_segment_size() == 3);
+    CHECK(!restored.full());
+    CHECK(restored.get_used_segments() == 5);
+    checkValueRange(restored, testee.get_max_size() + 3, testee.get_max_size() - 2);
+
+    //restored ring buffer is fully functional
+    restored.push_back(100);
+    restored.push_back(101);
+    CHECK(restored.full());
+    CHECK(restored.back() == 101);
+    restored.push_back(102);
+    CHECK(restored.front() == testee.get_max_size() + 4);
+}
+
+TEST_CASE("large_ring_buffer save and load full and empty", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(2, 2);
+    for (int i = 0; i < 4; ++i)
+    {
+        testee.push_back(i);
+    }
+    CHECK(testee.full());
+
+    std::stringstream stream;
+    testee.save(stream);
+    testee.clear();
+    testee.save(stream);
+
+    cpplargeringbuffer::large_ring_buffer<int> restored;
+    restored.load(stream);
+    CHECK(restored.full());
+    CHECK(restored.size() == 4);
+    CHECK(restored.front() == 0);
+    CHECK(restored.back() == 3);
+
+    restored.load(stream);
+    CHECK(restored.empty());
+    CHECK(restored.get_max_size() == 4);
+    CHECK(restored.get_used_segments() == 0);
+}
+
+TEST_CASE("large_ring_buffer load invalid snapshot", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(2, 2);
+    testee.push_back(1);
+    testee.push_back(2);
+    testee.push_back(3);
+
+    std::stringstream garbage("this is not a snapshot of a ring buffer");
+    CHECK_THROWS_AS(testee.load(garbage), std::runtime_error);
+    CHECK(testee.empty());
+    CHECK(testee.get_max_size() == 0);
+
+    cpplargeringbuffer::large_ring_buffer<int> source(2, 2);
+    source.push_back(1);
+    source.push_back(2);
+    source.push_back(3);
+    std::stringstream stream;
+    source.save(stream);
+    std::string data = stream.str();
+    std::stringstream truncated(data.substr(0, data.size() - sizeof(int)));
+    CHECK_THROWS_AS(testee.load(truncated), std::runtime_error);
+    CHECK(testee.empty());
+
+    std::stringstream stream_other_type;
+    cpplargeringbuffer::large_ring_buffer<char> other_type(1, 1);
+    other_type.save(stream_other_type);
+    CHECK_THROWS_AS(testee.load(stream_other_type), std::runtime_error);
+
+    //segment count and segment size whose product overflows
+    const std::uint64_t huge = std::uint64_t(1) << 40;
+    std::string overflow = data;
+    std::memcpy(&overflow[3 * sizeof(std::uint64_t)], &huge, sizeof(huge));
+    std::memcpy(&overflow[4 * sizeof(std::uint64_t)], &huge, sizeof(huge));
+    std::stringstream stream_overflow(overflow);
+    CHECK_THROWS_AS(testee.load(stream_overflow), std::runtime_error);
+    CHECK(testee.get_max_size() == 0);
+
+    const std::uint64_t too_large = std::numeric_limits<std::uint64_t>::max() / 2;
+    const std::uint64_t one = 1;
+    std::string exceeding = data;
+    std::memcpy(&exceeding[3 * sizeof(std::uint64_t)], &too_large, sizeof(too_large));
+    std::memcpy(&exceeding[4 * sizeof(std::uint64_t)], &one, sizeof(one));
+    std::stringstream stream_exceeding(exceeding);
+    CHECK_THROWS_AS(testee.load(stream_exceeding), std::runtime_error);
+    CHECK(testee.get_max_size() == 0);
+}
+
+TEST_CASE("static_large_ring_buffer defaults", "[static_large_ring_buffer]")
+{
+    const cpplargeringbuffer::static_large_ring_buffer<int, 5, 3> testee;
+
+    CHECK(testee.empty());
+    CHECK(!testee.full());
+    CHECK(testee.size() == 0);
+    CHECK(testee.get_max_size() == 15);
+    CHECK(testee.get_segment_size() == 3);
+    CHECK(testee.get_segment_count() == 5);
+    CHECK(testee.get_used_segments() == 0);
+}
+
+TEST_CASE("static_large_ring_buffer fill and remove", "[static_large_ring_buffer]")
+{
+    cpplargeringbuffer::static_large_ring_buffer<size_t, 5, 3> testee;
+    cpplargeringbuffer::large_ring_buffer<size_t> reference(5, 3);
+    const size_t max_value = 2 * testee.get_max_size() + testee.get_segment_size();
+
+    for (size_t i = 0; i < max_value; ++i)
+    {
+        testee.push_back(i);
+        reference.push_back(i);
+    }
+    checkValueRange(testee, testee.get_max_size() + testee.get_segment_size(), testee.get_max_size());
+    CHECK(testee.full());
+
+    for (size_t i = 0; i < max_value; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            testee.pop_front();
+            reference.pop_front();
+        }
+        else if (i % 3 == 1)
+        {
+            testee.pop_back();
+            reference.pop_back();
+        }
+        else
+        {
+            testee.push_front(i);
+            reference.push_front(i);
+        }
+        REQUIRE(testee.size() == reference.size());
+        CHECK(testee.get_used_segments() == reference.get_used_segments());
+        for (size_t j = 0; j < reference.size(); ++j)
+        {
+            CHECK(testee[j] == reference[j]);
+        }
+    }
+
+    testee.clear();
+    CHECK(testee.empty());
+    CHECK(testee.get_used_segments() == 0);
+    CHECK(testee.get_max_size() == 15);
+}
+
+TEST_CASE("static_large_ring_buffer save and load", "[static_large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> source(2, 3);
+    for (int i = 0; i < 8; ++i)
+    {
+        source.push_back(i);
+    }
+    std::stringstream stream;
+    source.save(stream);
+    const std::string data = stream.str();
+
+    cpplargeringbuffer::static_large_ring_buffer<int, 2, 3> testee;
+    std::stringstream matching(data);
+    testee.load(matching);
+    CHECK(testee.full());
+    CHECK(testee.front() == 2);
+    CHECK(testee.back() == 7);
+
+    cpplargeringbuffer::static_large_ring_buffer<int, 3, 2> other_geometry;
+    other_geometry.push_back(1);
+    std::stringstream not_matching(data);
+    CHECK_THROWS_AS(other_geometry.load(not_matching), std::runtime_error);
+    CHECK(other_geometry.empty());
+    CHECK(other_geometry.get_max_size() == 6);
+}
+
+TEST_CASE("large_ring_buffer iterators", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 3);
+    CHECK(testee.begin() == testee.end());
+
+    for (int i = 0; i < 17; ++i)
+    {
+        testee.push_back(i);
+    }
+    REQUIRE(testee.size() == 12);
+
+    int expected = 5;
+    for (int item : testee)
+    {
+        CHECK(item == expected++);
+    }
+    CHECK(std::distance(testee.begin(), testee.end()) == 12);
+    CHECK(std::accumulate(testee.cbegin(), testee.cend(), 0) == 5 + 6 + 7 + 8 + 9 + 10 + 11 + 12 + 13 + 14 + 15 + 16);
+
+    cpplargeringbuffer::large_ring_buffer<int>::const_iterator it = testee.begin() + 4;
+    CHECK(*it == 9);
+    CHECK(it[3] == 12);
+    CHECK(*--it == 8);
+    CHECK(*(it - 3) == 5);
+    CHECK(testee.end() - it == 9);
+    CHECK(it < testee.end());
+    CHECK(it >= testee.begin());
+
+    std::reverse(testee.begin(), testee.end());
+    CHECK(testee.front() == 16);
+    CHECK(testee.back() == 5);
+    std::sort(testee.begin(), testee.end());
+    CHECK(std::is_sorted(testee.cbegin(), testee.cend()));
+    CHECK(testee[0] == 5);
+
+    *testee.begin() = 42;
+    CHECK(testee.front() == 42);
+}
+
+TEST_CASE("large_ring_buffer for_each", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(5, 7);
+    for (int i = 0; i < 50; ++i)
+    {
+        testee.push_back(i);
+    }
+
+    for (size_t distance = 0; distance < 10; distance += 3)
+    {
+        testee.set_prefetch_distance(distance);
+        CHECK(testee.get_prefetch_distance() == distance);
+
+        int expected = 15;
+        const cpplargeringbuffer::large_ring_buffer<int>& const_testee = testee;
+        const_testee.for_each([&expected](const int& item)
+        {
+            CHECK(item == expected++);
+        });
+        CHECK(expected == 50);
+
+        std::vector<int> visited;
+        const_testee.for_each(4, 20, [&visited](const int& item)
+        {
+            visited.push_back(item);
+        });
+        REQUIRE(visited.size() == 20);
+        CHECK(visited.front() == 19);
+        CHECK(visited.back() == 38);
+
+        int expected_after = 15;
+        for (int item : testee)
+        {
+            CHECK(item == expected_after++);
+        }
+    }
+
+    testee.for_each([](int& item)
+    {
+        item *= 2;
+    });
+    CHECK(testee.front() == 30);
+    CHECK(testee.back() == 98);
+}
+
+TEST_CASE("large_ring_buffer aligned segments", "[large_ring_buffer]")
+{
+    typedef cpplargeringbuffer::aligned_allocator<char, 256> allocator_type;
+    cpplargeringbuffer::large_ring_buffer<char, cpplargeringbuffer::noop_clear_handler<char>, allocator_type> testee(4, 100);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        testee.push_back(static_cast<char>(i));
+        if (i % 100 == 0)
+        {
+            CHECK(reinterpret_cast<std::uintptr_t>(&testee.back()) % 256 == 0);
+        }
+    }
+    CHECK(testee.full());
+    CHECK(testee.front() == static_cast<char>(600));
+    CHECK(testee.back() == static_cast<char>(999));
+
+    cpplargeringbuffer::aligned_allocator<std::uint64_t, 4096> page_allocator;
+    for (size_t count = 1; count < 10000; count *= 3)
+    {
+        std::uint64_t* items = page_allocator.allocate(count);
+        CHECK(reinterpret_cast<std::uintptr_t>(items) % 4096 == 0);
+        items[count - 1] = count;
+        page_allocator.deallocate(items, count);
+    }
+    CHECK_THROWS_AS(page_allocator.allocate(std::numeric_limits<size_t>::max() / sizeof(std::uint64_t)), std::bad_alloc);
+
+    const cpplargeringbuffer::aligned_allocator<int, 4096> rebound(page_allocator);
+    CHECK(rebound == page_allocator);
+}
+
+TEST_CASE("large_ring_buffer reserve and commit", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 3);
+    std::vector<cpplargeringbuffer::item_span<int> > spans;
+
+    CHECK(testee.reserve_back(5, std::back_inserter(spans)) == 5);
+    REQUIRE(spans.size() == 2);
+    CHECK(spans[0].count == 3);
+    CHECK(spans[1].count == 2);
+    int value = 0;
+    for (const cpplargeringbuffer::item_span<int>& span : spans)
+    {
+        for (int& item : span)
+        {
+            item = value++;
+        }
+    }
+    CHECK(testee.empty());
+    testee.commit_back(4);
+    REQUIRE(testee.size() == 4);
+    CHECK(testee.front() == 0);
+    CHECK(testee.back() == 3);
+
+    // more than the maximum size
+    spans.clear();
+    CHECK(testee.reserve_back(20, std::back_inserter(spans)) == 12);
+    CHECK(testee.empty());
+    testee.commit_back(0);
+    CHECK(testee.empty());
+
+    spans.clear();
+    CHECK(testee.reserve_back(12, std::back_inserter(spans)) == 12);
+    for (const cpplargeringbuffer::item_span<int>& span : spans)
+    {
+        for (int& item : span)
+        {
+            item = value++;
+        }
+    }
+    testee.commit_back(12);
+    CHECK(testee.full());
+    CHECK(testee.front() == 5);
+    CHECK(testee.back() == 16);
+}
+
+TEST_CASE("large_ring_buffer modifications discard reservations", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 3);
+    std::vector<cpplargeringbuffer::item_span<int> > spans;
+
+    CHECK(testee.reserve_back(3, std::back_inserter(spans)) == 3);
+    testee.push_back(7);
+    testee.commit_back(3);
+    REQUIRE(testee.size() == 1);
+    CHECK(testee.front() == 7);
+
+    spans.clear();
+    CHECK(testee.reserve_back(2, std::back_inserter(spans)) == 2);
+    testee.pop_front();
+    testee.commit_back(2);
+    CHECK(testee.empty());
+
+    testee.push_back(1);
+    spans.clear();
+    CHECK(testee.reserve_back(2, std::back_inserter(spans)) == 2);
+    testee.pop_back();
+    testee.commit_back(2);
+    CHECK(testee.empty());
+
+    spans.clear();
+    CHECK(testee.reserve_back(2, std::back_inserter(spans)) == 2);
+    testee.clear();
+    testee.commit_back(2);
+    CHECK(testee.empty());
+
+    // a reservation is committed once
+    spans.clear();
+    CHECK(testee.reserve_back(2, std::back_inserter(spans)) == 2);
+    spans[0].items[0] = 1;
+    spans[0].items[1] = 2;
+    testee.commit_back(2);
+    testee.commit_back(2);
+    CHECK(testee.size() == 2);
+}
+
+TEST_CASE("large_ring_buffer reserve and commit matches push_back", "[large_ring_buffer]")
+{
+    //without an eviction handler items are overwritten one at a time, evicting with a handler is tested with the segment_spiller
+    cpplargeringbuffer::large_ring_buffer<int, cpplargeringbuffer::assign_default_clear_handler<int> > reference(5, 4);
+    cpplargeringbuffer::large_ring_buffer<int, cpplargeringbuffer::assign_default_clear_handler<int> > testee(5, 4);
+
+    int value = 1;
+    for (size_t count = 0; count < 40; ++count)
+    {
+        std::vector<cpplargeringbuffer::item_span<int> > spans;
+        const size_t reserved = testee.reserve_back(count % 23, std::back_inserter(spans));
+        size_t spanned = 0;
+        for (const cpplargeringbuffer::item_span<int>& span : spans)
+        {
+            for (int& item : span)
+            {
+                reference.push_back(value);
+                item = value++;
+            }
+            spanned += span.count;
+        }
+        CHECK(spanned == reserved);
+        testee.commit_back(reserved);
+
+        REQUIRE(testee.size() == reference.size());
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            REQUIRE(testee[i] == reference[i]);
+        }
+        CHECK(testee.full() == reference.full());
+
+        if (count % 7 == 0 && !testee.empty())
+        {
+            testee.pop_front();
+            reference.pop_front();
+        }
+    }
+    CHECK(testee.full());
+}
+
+TEST_CASE("large_ring_buffer peek and release", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 3);
+    for (int i = 0; i < 14; ++i)
+    {
+        testee.push_back(i);
+    }
+
+    std::vector<cpplargeringbuffer::item_span<const int> > spans;
+    const cpplargeringbuffer::large_ring_buffer<int>& const_testee = testee;
+    CHECK(const_testee.peek_front(100, std::back_inserter(spans)) == 12);
+    REQUIRE(spans.size() == 5);
+    CHECK(spans[0].count == 1);
+    CHECK(spans[4].count == 2);
+    int expected = 2;
+    for (const cpplargeringbuffer::item_span<const int>& span : spans)
+    {
+        for (const int& item : span)
+        {
+            CHECK(item == expected++);
+        }
+    }
+    CHECK(testee.size() == 12);
+
+    std::vector<cpplargeringbuffer::item_span<int> > writable_spans;
+    CHECK(testee.peek_front(2, std::back_inserter(writable_spans)) == 2);
+    REQUIRE(writable_spans.size() == 2);
+    writable_spans[1].items[0] = 42;
+    CHECK(testee[1] == 42);
+
+    testee.release_front(5);
+    CHECK(testee.size() == 7);
+    CHECK(testee.front() == 7);
+    CHECK(!testee.full());
+    testee.release_front(0);
+    CHECK(testee.size() == 7);
+    testee.release_front(7);
+    CHECK(testee.empty());
+}
+
+TEST_CASE("large_ring_buffer release_front matches pop_front", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int, cpplargeringbuffer::assign_default_clear_handler<int> > reference(6, 5);
+    cpplargeringbuffer::large_ring_buffer<int, cpplargeringbuffer::assign_default_clear_handler<int> > testee(6, 5);
+
+    int value = 0;
+    for (size_t round = 0; round < 60; ++round)
+    {
+        for (size_t i = 0; i < round % 17; ++i)
+        {
+            reference.push_back(value);
+            testee.push_back(value++);
+        }
+        const size_t count = (round * 7) % (testee.size() + 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            reference.pop_front();
+        }
+        testee.release_front(count);
+
+        REQUIRE(testee.size() == reference.size());
+        CHECK(testee.get_used_segments() == reference.get_used_segments());
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            REQUIRE(testee[i] == reference[i]);
+        }
+    }
+}
+
+TEST_CASE("large_ring_buffer expire_front", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(10, 100);
+    for (int i = 0; i < 1000; ++i)
+    {
+        testee.push_back(i);
+    }
+    size_t projections = 0;
+    const auto timestamp = [&projections](int item)
+    {
+        ++projections;
+        return item;
+    };
+
+    CHECK(testee.expire_front(0, timestamp) == 0);
+    CHECK(testee.expire_front(550, timestamp) == 550);
+    CHECK(testee.size() == 450);
+    CHECK(testee.front() == 550);
+    CHECK(testee.get_used_segments() <= 7); // 5 with items and the spare segments next to start and end
+    // five whole segments by their last item, the sixth by binary search
+    CHECK(projections < 30);
+
+    projections = 0;
+    CHECK(testee.expire_front(550, timestamp) == 0);
+    CHECK(projections < 10);
+
+    CHECK(testee.expire_front(5000, timestamp) == 450);
+    CHECK(testee.empty());
+    CHECK(testee.expire_front(5000, timestamp) == 0);
+}
+
+TEST_CASE("large_ring_buffer resize segments keeps items in place", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 5);
+    for (int i = 0; i < 27; ++i)
+    {
+        testee.push_back(i);
+    }
+    // wrapped: items 7..26, start in the middle of a segment
+    REQUIRE(testee.full());
+    std::vector<const int*> addresses;
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        addresses.push_back(&testee[i]);
+    }
+
+    testee.resize_segments(10);
+    CHECK(testee.get_segment_count() == 10);
+    CHECK(testee.get_max_size() == 50);
+    REQUIRE(testee.size() == 20);
+    size_t moved = 0;
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        CHECK(testee[i] == static_cast<int>(i) + 7);
+        moved += (&testee[i] != addresses[i]) ? 1 : 0;
+    }
+    // only the items that wrapped into the start segment are moved
+    CHECK(moved == 2);
+    CHECK(!testee.full());
+
+    for (int i = 27; i < 60; ++i)
+    {
+        testee.push_back(i);
+    }
+    CHECK(testee.full());
+    CHECK(testee.front() == 10);
+    CHECK(testee.back() == 59);
+
+    CHECK_THROWS_AS(testee.resize_segments(0), std::range_error);
+    cpplargeringbuffer::large_ring_buffer<int> unconfigured;
+    CHECK_THROWS_AS(unconfigured.resize_segments(2), std::range_error);
+}
+
+TEST_CASE("large_ring_buffer resize segments shrinks", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(10, 5);
+    for (int i = 0; i < 32; ++i)
+    {
+        testee.push_back(i);
+    }
+    // only the oldest items that do not fit are removed
+    testee.resize_segments(3);
+    CHECK(testee.get_max_size() == 15);
+    REQUIRE(testee.size() == 15);
+    CHECK(testee.front() == 17);
+    CHECK(testee.back() == 31);
+    CHECK(testee.full());
+
+    testee.pop_front();
+    testee.pop_front();
+    testee.resize_segments(2);
+    REQUIRE(testee.size() == 10);
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        CHECK(testee[i] == static_cast<int>(i) + 22);
+    }
+    CHECK(testee.full());
+    CHECK(testee.get_used_segments() == 2);
+}
+
+TEST_CASE("large_ring_buffer resize segments keeps items that fit", "[large_ring_buffer]")
+{
+    // full and wrapped, resizing to the same segment count changes nothing
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 8);
+    for (int i = 0; i < 36; ++i)
+    {
+        testee.push_back(i);
+    }
+    testee.resize_segments(4);
+    REQUIRE(testee.size() == 32);
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        CHECK(testee[i] == static_cast<int>(i) + 4);
+    }
+
+    // 24 items wrap around the end of the smaller layout
+    cpplargeringbuffer::large_ring_buffer<int> shrinking(4, 8);
+    for (int i = 0; i < 29; ++i)
+    {
+        shrinking.push_back(i);
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+        shrinking.pop_front();
+    }
+    shrinking.resize_segments(3);
+    REQUIRE(shrinking.size() == 24);
+    CHECK(shrinking.full());
+    for (size_t i = 0; i < shrinking.size(); ++i)
+    {
+        CHECK(shrinking[i] == static_cast<int>(i) + 5);
+    }
+    shrinking.push_back(29);
+    CHECK(shrinking.front() == 6);
+    CHECK(shrinking.back() == 29);
+}
+
+TEST_CASE("large_ring_buffer resize segments random", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int, cpplargeringbuffer::assign_default_clear_handler<int> > testee(3, 4);
+    std::deque<int> reference;
+    std::mt19937 random(7);
+    int value = 0;
+
+    for (int round = 0; round < 3000; ++round)
+    {
+        const unsigned int operation = random() % 10;
+        if (operation < 5)
+        {
+            testee.push_back(value);
+            reference.push_back(value++);
+            if (reference.size() > testee.get_max_size())
+            {
+                reference.pop_front();
+            }
+        }
+        else if (operation < 8)
+        {
+            if (!reference.empty())
+            {
+                testee.pop_front();
+                reference.pop_front();
+            }
+        }
+        else
+        {
+            testee.resize_segments(1 + random() % 8);
+            const size_t expected = reference.size() < testee.get_max_size() ? reference.size() : testee.get_max_size();
+            REQUIRE(testee.size() == expected);
+            while (reference.size() > expected)
+            {
+                reference.pop_front();
+            }
+        }
+
+        REQUIRE(testee.size() == reference.size());
+        REQUIRE(testee.full() == (testee.size() == testee.get_max_size()));
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            REQUIRE(testee[i] == reference[i]);
+        }
+    }
+}
+
+TEST_CASE("large_ring_buffer recommended geometry", "[large_ring_buffer]")
+{
+    using namespace cpplargeringbuffer;
+    geometry g = recommended_geometry(100000000, 8);
+    REQUIRE(g.segment_size == 256 * 1024 / 8);
+    REQUIRE(g.number_of_segments * g.segment_size >= 100000000);
+
+    geometry_hints hints;
+    hints.pattern = access_pattern::random;
+    g = recommended_geometry(100000000, 8, hints);
+    REQUIRE(g.segment_size == 64 * 1024 / 8);
+    REQUIRE(g.number_of_segments * g.segment_size >= 100000000);
+
+    // small capacity keeps at least min_segments segments
+    g = recommended_geometry(1000, 8);
+    REQUIRE(g.number_of_segments >= 16);
+    REQUIRE(g.number_of_segments * g.segment_size >= 1000);
+
+    // huge capacity keeps at most max_segments segments
+    hints.max_segments = 100;
+    g = recommended_geometry(100000000, 8, hints);
+    REQUIRE(g.number_of_segments <= 100);
+    REQUIRE(g.segment_size % (4096 / 8) == 0);
+
+    // odd item sizes are not rounded to pages
+    g = recommended_geometry(10000000, 24);
+    REQUIRE(g.segment_size == 256 * 1024 / 24);
+
+    REQUIRE(recommended_geometry(0, 8).number_of_segments == 0);
+}
+
+TEST_CASE("large_ring_buffer allocation statistics", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(8, 4);
+    REQUIRE(testee.get_allocation_statistics().allocated_segments == 0);
+    for (int i = 0; i < 10; ++i)
+    {
+        testee.push_back(i);
+    }
+    REQUIRE(testee.get_allocation_statistics().allocated_segments == 3);
+    REQUIRE(testee.get_allocation_statistics().used_segments == 3);
+    REQUIRE(testee.get_allocation_statistics().peak_used_segments == 3);
+
+    // churn within a few segments frees and allocates again
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            testee.push_back(i);
+        }
+        for (int i = 0; i < 8; ++i)
+        {
+            testee.pop_front();
+        }
+    }
+    const cpplargeringbuffer::allocation_statistics statistics = testee.get_allocation_statistics();
+    REQUIRE(statistics.used_segments == testee.get_used_segments());
+    REQUIRE(statistics.released_segments > 4 * statistics.peak_used_segments);
+    REQUIRE(statistics.allocated_segments - statistics.released_segments == statistics.used_segments);
+
+    cpplargeringbuffer::geometry_hints hints;
+    hints.min_segments = 2;
+    hints.page_size = 0;
+    cpplargeringbuffer::geometry current = { 8, 4 };
+    cpplargeringbuffer::geometry tuned = cpplargeringbuffer::recommended_geometry(current, sizeof(int), statistics, hints);
+    REQUIRE(tuned.segment_size == 8);
+    REQUIRE(tuned.number_of_segments == 4);
+
+    // rarely used buffer gets smaller segments
+    cpplargeringbuffer::allocation_statistics idle;
+    idle.allocated_segments = 1;
+    idle.used_segments = 1;
+    idle.peak_used_segments = 1;
+    tuned = cpplargeringbuffer::recommended_geometry(current, sizeof(int), idle, hints);
+    REQUIRE(tuned.segment_size == 2);
+    REQUIRE(tuned.number_of_segments == 16);
+
+    testee.clear();
+    REQUIRE(testee.get_allocation_statistics().used_segments == 0);
+    testee.discard_and_change_configuration(4, 4);
+    REQUIRE(testee.get_allocation_statistics().released_segments == 0);
+}
+
+TEST_CASE("large_ring_buffer segment release policy", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::segment_release_policy policy;
+    REQUIRE(policy.mode == cpplargeringbuffer::release_mode::keep_spare);
+    REQUIRE(policy.spare_segments == 0);
+
+    cpplargeringbuffer::large_ring_buffer<int> default_policy(64, 8);
+    const size_t default_allocations = run_sawtooth(default_policy, 100);
+    REQUIRE(default_allocations > 300);
+
+    cpplargeringbuffer::large_ring_buffer<int> spare(64, 8);
+    policy.spare_segments = 5;
+    spare.set_segment_release_policy(policy);
+    REQUIRE(spare.get_segment_release_policy().spare_segments == 5);
+    REQUIRE(run_sawtooth(spare, 100) < default_allocations / 2);
+    REQUIRE(spare.get_used_segments() <= 2 + 2 * 5);
+
+    cpplargeringbuffer::large_ring_buffer<int> never(64, 8);
+    policy.mode = cpplargeringbuffer::release_mode::never;
+    never.set_segment_release_policy(policy);
+    REQUIRE(run_sawtooth(never, 100) == 64);
+    REQUIRE(never.get_used_segments() == 64);
+    REQUIRE(never.release_unused_segments() == 63);
+    REQUIRE(never.get_used_segments() == 1);
+    REQUIRE(never.get_allocation_statistics().used_segments == 1);
+    REQUIRE(never.size() == 8);
+    for (size_t i = 0; i < never.size(); ++i)
+    {
+        REQUIRE(never[i] == static_cast<int>(3200 + i));
+    }
+
+    cpplargeringbuffer::large_ring_buffer<int> idle(64, 8);
+    policy.mode = cpplargeringbuffer::release_mode::when_idle;
+    policy.idle_operations = 16;
+    idle.set_segment_release_policy(policy);
+    REQUIRE(run_sawtooth(idle, 100) < default_allocations / 2);
+    REQUIRE(idle.get_used_segments() < 64);
+
+    // an idle buffer returns its memory
+    for (int i = 0; i < 200; ++i)
+    {
+        idle.push_back(i);
+        idle.pop_front();
+    }
+    REQUIRE(idle.get_used_segments() <= 4);
+}
+
+TEST_CASE("large_ring_buffer segment release policies keep the items", "[large_ring_buffer]")
+{
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        cpplargeringbuffer::segment_release_policy policy;
+        policy.mode = static_cast<cpplargeringbuffer::release_mode>(mode);
+        policy.spare_segments = 2;
+        policy.idle_operations = 3;
+        cpplargeringbuffer::large_ring_buffer<int> testee(6, 4);
+        testee.set_segment_release_policy(policy);
+        std::deque<int> reference;
+        std::mt19937 random(mode);
+        int value = 0;
+        for (int round = 0; round < 5000; ++round)
+        {
+            const unsigned int operation = random() % 10;
+            if (operation < 5)
+            {
+                testee.push_back(value);
+                reference.push_back(value++);
+                if (reference.size() > testee.get_max_size())
+                {
+                    reference.pop_front();
+                }
+            }
+            else if (!reference.empty() && operation < 8)
+            {
+                testee.pop_front();
+                reference.pop_front();
+            }
+            else if (!reference.empty() && operation < 9)
+            {
+                testee.pop_back();
+                reference.pop_back();
+            }
+            else
+            {
+                testee.release_unused_segments();
+            }
+            REQUIRE(testee.size() == reference.size());
+            REQUIRE(testee.get_allocation_statistics().used_segments == testee.get_used_segments());
+            for (size_t i = 0; i < reference.size(); ++i)
+            {
+                REQUIRE(testee[i] == reference[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("large_ring_buffer deferred segment release", "[large_ring_buffer]")
+{
+    {
+        cpplargeringbuffer::large_ring_buffer<counted_item> testee(8, 4);
+        REQUIRE_FALSE(testee.is_deferred_release());
+        testee.set_deferred_release(true);
+        REQUIRE(testee.is_deferred_release());
+        for (int i = 0; i < 32; ++i)
+        {
+            testee.extend_back().value = i;
+        }
+        REQUIRE(counted_item::live == 32);
+
+        // popping does not destroy the items of unused segments
+        for (int i = 0; i < 24; ++i)
+        {
+            REQUIRE(testee.front().value == i);
+            testee.pop_front();
+        }
+        REQUIRE(testee.get_used_segments() < 8);
+        REQUIRE(testee.get_retired_segments() == 8 - testee.get_used_segments());
+        REQUIRE(counted_item::live == 32);
+
+        REQUIRE(testee.reclaim() == 8 - testee.get_used_segments());
+        REQUIRE(testee.get_retired_segments() == 0);
+        REQUIRE(counted_item::live == static_cast<int>(4 * testee.get_used_segments()));
+
+        // retired segments can be freed on another thread
+        for (int i = 0; i < 32; ++i)
+        {
+            testee.extend_back().value = i;
+        }
+        testee.clear();
+        REQUIRE(testee.get_used_segments() == 0);
+        REQUIRE(counted_item::live == 32);
+        std::vector<std::vector<counted_item> > retired;
+        testee.take_retired_segments(retired);
+        REQUIRE(retired.size() == 8);
+        REQUIRE(testee.get_retired_segments() == 0);
+        std::thread reclaimer([&retired]()
+        {
+            retired.clear();
+        });
+        reclaimer.join();
+        REQUIRE(counted_item::live == 0);
+
+        // the vector is passed again, handing over the segments swaps the reserved buffers
+        const std::vector<counted_item>* buffer = retired.data();
+        testee.take_retired_segments(retired);
+        testee.take_retired_segments(retired);
+        REQUIRE(retired.data() == buffer);
+        REQUIRE(retired.capacity() >= 8);
+
+        // retired segments are freed by a configuration change and with the ring buffer
+        testee.extend_back().value = 1;
+        testee.clear();
+        REQUIRE(testee.get_retired_segments() == 1);
+        testee.discard_and_change_configuration(4, 2);
+        REQUIRE(testee.get_retired_segments() == 0);
+        REQUIRE(counted_item::live == 0);
+        testee.extend_back().value = 1;
+        testee.clear();
+        REQUIRE(testee.get_retired_segments() == 1);
+    }
+    REQUIRE(counted_item::live == 0);
+
+    {
+        // without reclaim() retired segments are reused, they never exceed the number of segments
+        cpplargeringbuffer::large_ring_buffer<counted_item> testee(4, 4);
+        testee.set_deferred_release(true);
+        for (int round = 0; round < 20; ++round)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                testee.extend_back().value = i;
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                testee.pop_front();
+            }
+            REQUIRE(testee.get_retired_segments() <= 4);
+            REQUIRE(counted_item::live <= 16);
+        }
+        REQUIRE(testee.reclaim() + testee.get_used_segments() <= 4);
+    }
+    REQUIRE(counted_item::live == 0);
+
+    cpplargeringbuffer::static_large_ring_buffer<int, 4, 4> fixed;
+    fixed.set_deferred_release(true);
+    for (int i = 0; i < 16; ++i)
+    {
+        fixed.push_back(i);
+    }
+    fixed.clear();
+    REQUIRE(fixed.get_retired_segments() == 4);
+    REQUIRE(fixed.reclaim() == 4);
+}
+
+TEST_CASE("large_ring_buffer zero_page_allocator", "[large_ring_buffer]")
+{
+    typedef cpplargeringbuffer::zero_page_allocator<std::uint64_t> allocator_type;
+    REQUIRE(allocator_type() == cpplargeringbuffer::zero_page_allocator<int>());
+    REQUIRE_FALSE(allocator_type() != cpplargeringbuffer::zero_page_allocator<int>());
+
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t, cpplargeringbuffer::noop_clear_handler<std::uint64_t>, allocator_type> testee(8, 1000);
+    testee.reserve_all();
+    REQUIRE(testee.get_used_segments() == 8);
+    testee.for_each_segment([](const std::uint64_t* items, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            REQUIRE(items[i] == 0);
+        }
+    });
+    for (std::uint64_t i = 0; i < 10000; ++i)
+    {
+        testee.push_back(i);
+    }
+    REQUIRE(testee.size() == 8000);
+    REQUIRE(testee.front() == 2000);
+    REQUIRE(testee.back() == 9999);
+
+    // types that are not trivially default constructible are constructed
+    cpplargeringbuffer::large_ring_buffer<nonzero_item, cpplargeringbuffer::noop_clear_handler<nonzero_item>, cpplargeringbuffer::zero_page_allocator<nonzero_item> > constructed(4, 100);
+    constructed.reserve_all(2);
+    constructed.for_each_segment([](const nonzero_item* items, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            REQUIRE(items[i].value == 42);
+        }
+    });
+
+    // only arithmetic and enumeration types or types opted in are left zero
+    REQUIRE(cpplargeringbuffer::is_zero_initialized<std::uint64_t>::value);
+    REQUIRE(cpplargeringbuffer::is_zero_initialized<zero_item>::value);
+    REQUIRE_FALSE(cpplargeringbuffer::is_zero_initialized<member_pointer>::value);
+    std::vector<zero_item, cpplargeringbuffer::zero_page_allocator<zero_item> > zero_items(10);
+    REQUIRE(zero_items[9].value == 0);
+    REQUIRE(zero_items[9].weight == 0.0);
+
+    // a value initialized pointer to a data member is not all zero bytes
+    std::vector<member_pointer, cpplargeringbuffer::zero_page_allocator<member_pointer> > members(10);
+    for (member_pointer member : members)
+    {
+        REQUIRE(member == nullptr);
+    }
+
+    // emplace style construction with arguments
+    std::vector<std::string, cpplargeringbuffer::zero_page_allocator<std::string> > strings;
+    strings.emplace_back(3, 'x');
+    strings.resize(3);
+    REQUIRE(strings[0] == "xxx");
+    REQUIRE(strings[2].empty());
+}
+
+TEST_CASE("large_ring_buffer trivially copyable fast paths are equivalent", "[large_ring_buffer]")
+{
+    check_bulk_equivalence<int, cpplargeringbuffer::assign_default_clear_handler<int> >(0);
+    check_bulk_equivalence<double, cpplargeringbuffer::assign_default_clear_handler<double> >(0.0);
+    check_bulk_equivalence<std::string, cpplargeringbuffer::assign_default_clear_handler<std::string> >(std::string());
+    check_bulk_equivalence<nonzero_item, cpplargeringbuffer::assign_default_clear_handler<nonzero_item> >(nonzero_item());
+    check_bulk_equivalence<clearable_item, cpplargeringbuffer::clearable_clear_handler<clearable_item> >(clearable_item());
+    check_bulk_equivalence<int, counting_clear_handler>(-1);
+}
+
+TEST_CASE("large_ring_buffer clear_items", "[large_ring_buffer]")
+{
+    int trivial[4] = { 1, 2, 3, 4 };
+    cpplargeringbuffer::clear_items<cpplargeringbuffer::assign_default_clear_handler<int> >(trivial, 3, 0);
+    REQUIRE(trivial[0] == 0);
+    REQUIRE(trivial[2] == 0);
+    REQUIRE(trivial[3] == 4);
+
+    nonzero_item constructed[2];
+    constructed[0].value = 1;
+    constructed[1].value = 2;
+    cpplargeringbuffer::clear_items<cpplargeringbuffer::assign_default_clear_handler<nonzero_item> >(constructed, 2, 0);
+    REQUIRE(constructed[0].value == 42);
+    REQUIRE(constructed[1].value == 42);
+
+    // handlers without clear_range are called for each item
+    counting_clear_handler::calls = 0;
+    cpplargeringbuffer::clear_items<counting_clear_handler>(trivial, 4, 0);
+    REQUIRE(counting_clear_handler::calls == 4);
+    REQUIRE(trivial[3] == -1);
+
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 4);
+    std::vector<int> items(100);
+    std::iota(items.begin(), items.end(), 0);
+    testee.push_back(items.data(), items.size());
+    REQUIRE(testee.size() == 16);
+    REQUIRE(testee.front() == 84);
+    REQUIRE(testee.back() == 99);
+    testee.push_back(items.data(), 0);
+    REQUIRE(testee.size() == 16);
+}
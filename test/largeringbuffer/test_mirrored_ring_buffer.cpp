@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/mirrored_ring_buffer.hpp>
+#include <deque>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("mirrored_ring_buffer defaults", "[mirrored_ring_buffer]")
+{
+    const cpplargeringbuffer::mirrored_ring_buffer<int> testee;
+
+    CHECK(testee.empty());
+    CHECK(!testee.full());
+    CHECK(testee.size() == 0);
+    CHECK(testee.get_max_size() == 0);
+}
+
+TEST_CASE("mirrored_ring_buffer capacity fills whole pages", "[mirrored_ring_buffer]")
+{
+    cpplargeringbuffer::mirrored_ring_buffer<int> testee(10);
+    const size_t granularity = cpplargeringbuffer::mirrored_memory::get_granularity();
+
+    CHECK(testee.get_max_size() >= 10);
+    CHECK((testee.get_max_size() * sizeof(int)) % granularity == 0);
+
+    cpplargeringbuffer::mirrored_ring_buffer<char[3]> odd(10);
+    CHECK(odd.get_max_size() >= 10);
+    CHECK((odd.get_max_size() * 3) % granularity == 0);
+}
+
+TEST_CASE("mirrored_ring_buffer rejects sizes that cannot be mapped", "[mirrored_ring_buffer]")
+{
+    const size_t minimum_size = std::numeric_limits<size_t>::max() / 4;
+    CHECK_THROWS_AS(cpplargeringbuffer::mirrored_ring_buffer<int>(minimum_size), std::range_error);
+
+    cpplargeringbuffer::mirrored_ring_buffer<int> testee(10);
+    CHECK_THROWS_AS(testee.discard_and_change_configuration(minimum_size), std::range_error);
+    CHECK(testee.get_max_size() == 0);
+}
+
+TEST_CASE("mirrored_ring_buffer contiguous across wrap", "[mirrored_ring_buffer]")
+{
+    cpplargeringbuffer::mirrored_ring_buffer<char> testee(1);
+    const size_t max_size = testee.get_max_size();
+
+    for (size_t i = 0; i < max_size + max_size / 2; ++i)
+    {
+        testee.push_back(static_cast<char>('a' + i % 26));
+    }
+    REQUIRE(testee.full());
+    CHECK(testee.size() == max_size);
+
+    //the content wraps around the end of the buffer but data() is one contiguous range
+    const std::string content(testee.data(), testee.size());
+    for (size_t i = 0; i < max_size; ++i)
+    {
+        CHECK(content[i] == static_cast<char>('a' + (i + max_size / 2) % 26));
+        CHECK(testee[i] == content[i]);
+    }
+    CHECK(testee.front() == content.front());
+    CHECK(testee.back() == content.back());
+    CHECK_THROWS_AS(testee.at(max_size), std::range_error);
+}
+
+TEST_CASE("mirrored_ring_buffer random operations", "[mirrored_ring_buffer]")
+{
+    cpplargeringbuffer::mirrored_ring_buffer<int> testee(1000);
+    const size_t max_size = testee.get_max_size();
+    std::deque<int> reference;
+    std::mt19937 random(42);
+    int next = 0;
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        switch (random() % 4)
+        {
+        case 0:
+        {
+            testee.push_back(next);
+            reference.push_back(next++);
+            break;
+        }
+        case 1:
+        {
+            std::vector<int> items(random() % (max_size + max_size / 4));
+            for (int& item : items)
+            {
+                item = next++;
+            }
+            testee.push_back(items.data(), items.size());
+            reference.insert(reference.end(), items.begin(), items.end());
+            break;
+        }
+        case 2:
+        {
+            const size_t count = random() % (testee.size() + 1);
+            testee.pop_front(count);
+            reference.erase(reference.begin(), reference.begin() + static_cast<std::ptrdiff_t>(count));
+            break;
+        }
+        default:
+            if (!testee.empty())
+            {
+                testee.pop_back();
+                reference.pop_back();
+            }
+            break;
+        }
+        while (reference.size() > max_size)
+        {
+            reference.pop_front();
+        }
+
+        REQUIRE(testee.size() == reference.size());
+        const int* data = testee.data();
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            REQUIRE(data[i] == reference[i]);
+        }
+    }
+
+    testee.clear();
+    CHECK(testee.empty());
+    CHECK(testee.get_max_size() == max_size);
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/prefault.hpp>
+#include <cstdint>
+#include <vector>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+TEST_CASE("reserve_all allocates all segments", "[prefault]")
+{
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t> testee(16, 1024);
+    testee.push_back(1);
+    testee.reserve_all();
+    REQUIRE(testee.get_used_segments() == 16);
+    REQUIRE(testee.get_allocation_statistics().allocated_segments == 16);
+    REQUIRE(testee.size() == 1);
+    REQUIRE(testee.front() == 1);
+
+    size_t segments = 0;
+    testee.for_each_segment([&segments](const std::uint64_t*, size_t count)
+    {
+        REQUIRE(count == 1024);
+        ++segments;
+    });
+    REQUIRE(segments == 16);
+}
+
+TEST_CASE("reserve_all with threads", "[prefault]")
+{
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t> testee(37, 1000);
+    testee.reserve_all(4);
+    REQUIRE(testee.get_used_segments() == 37);
+    REQUIRE(testee.get_allocation_statistics().used_segments == 37);
+    REQUIRE(testee.get_allocation_statistics().peak_used_segments == 37);
+
+    // more threads than segments
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t> small(2, 10);
+    small.reserve_all(8);
+    REQUIRE(small.get_used_segments() == 2);
+}
+
+TEST_CASE("prefault keeps segments allocated", "[prefault]")
+{
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t> testee(8, 512);
+    cpplargeringbuffer::prefault_options options;
+    options.threads = 2;
+    cpplargeringbuffer::prefault(testee, options);
+    REQUIRE(testee.get_segment_release_policy().mode == cpplargeringbuffer::release_mode::never);
+    REQUIRE(testee.get_used_segments() == 8);
+
+    // steady state appends and removals never allocate
+    for (std::uint64_t i = 0; i < 100000; ++i)
+    {
+        testee.push_back(i);
+        if (i % 3 == 0)
+        {
+            testee.pop_front();
+        }
+    }
+    while (!testee.empty())
+    {
+        testee.pop_front();
+    }
+    REQUIRE(testee.get_used_segments() == 8);
+    REQUIRE(testee.get_allocation_statistics().allocated_segments == 8);
+    REQUIRE(testee.get_allocation_statistics().released_segments == 0);
+}
+
+TEST_CASE("prefault locks memory", "[prefault]")
+{
+    cpplargeringbuffer::virtual_memory_large_ring_buffer<std::uint64_t> testee(4, 512);
+    cpplargeringbuffer::prefault_options options;
+    options.lock_memory = true;
+    bool locked = true;
+    try
+    {
+        cpplargeringbuffer::prefault(testee, options);
+    }
+    catch (const std::runtime_error&)
+    {
+        // the limit for locked memory may be zero in restricted environments
+        locked = false;
+    }
+    REQUIRE(testee.get_used_segments() == 4);
+    if (locked)
+    {
+        cpplargeringbuffer::unlock_segments(testee);
+    }
+    for (std::uint64_t i = 0; i < 2048; ++i)
+    {
+        testee.push_back(i);
+    }
+    REQUIRE(testee.front() == 0);
+    REQUIRE(testee.back() == 2047);
+}
+
+#if defined(__linux__)
+TEST_CASE("prefault makes segments resident", "[prefault]")
+{
+    // large calloc allocations are mapped to zero pages, allocating and constructing the items does not touch them
+    typedef cpplargeringbuffer::zero_page_allocator<std::uint64_t> allocator_type;
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t, cpplargeringbuffer::noop_clear_handler<std::uint64_t>, allocator_type> testee(4, 1024 * 1024);
+    cpplargeringbuffer::prefault(testee);
+
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t segments = 0;
+    size_t missing_pages = 0;
+    testee.for_each_segment([&](const std::uint64_t* items, size_t count)
+    {
+        const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(items) / page_size * page_size;
+        const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(items + count);
+        std::vector<unsigned char> resident((end - begin + page_size - 1) / page_size);
+        REQUIRE(mincore(reinterpret_cast<void*>(begin), end - begin, resident.data()) == 0);
+        for (unsigned char page : resident)
+        {
+            missing_pages += (page & 1) ? 0 : 1;
+        }
+        ++segments;
+    });
+    REQUIRE(segments == 4);
+    REQUIRE(missing_pages == 0);
+}
+#endif
@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/retention_large_ring_buffer.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace
+{
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    struct sample
+    {
+        time_point time;
+        int value;
+    };
+
+    struct time_of
+    {
+        time_point operator()(const sample& item) const
+        {
+            return item.time;
+        }
+    };
+
+    typedef cpplargeringbuffer::retention_large_ring_buffer<sample, time_of, std::chrono::minutes> retention_type;
+
+    struct tick_sample
+    {
+        std::uint64_t tick;
+        int value;
+    };
+
+    struct tick_of
+    {
+        std::uint64_t operator()(const tick_sample& item) const
+        {
+            return item.tick;
+        }
+    };
+}
+
+TEST_CASE("retention_large_ring_buffer keeps retention period", "[retention_large_ring_buffer]")
+{
+    retention_type testee(100, 64, std::chrono::minutes(15));
+    CHECK(testee.get_retention() == std::chrono::minutes(15));
+    const time_point start = std::chrono::steady_clock::now();
+
+    // one sample per second for one hour
+    for (int second = 0; second < 3600; ++second)
+    {
+        const sample item = { start + std::chrono::seconds(second), second };
+        testee.push_back(item);
+    }
+    CHECK(testee.size() == 15 * 60 + 1);
+    CHECK(testee.front().value == 3599 - 15 * 60);
+    CHECK(testee.back().value == 3599);
+    CHECK(testee.get_ring_buffer().get_used_segments() <= 17);
+
+    // nothing added for five minutes
+    CHECK(testee.expire(start + std::chrono::seconds(3599) + std::chrono::minutes(5)) == 300);
+    CHECK(testee.front().value == 3599 - 10 * 60);
+    CHECK(testee.expire(start + std::chrono::hours(2)) == 10 * 60 + 1);
+    CHECK(testee.empty());
+}
+
+TEST_CASE("retention_large_ring_buffer capacity still applies", "[retention_large_ring_buffer]")
+{
+    retention_type testee(2, 10, std::chrono::minutes(15));
+    const time_point start = std::chrono::steady_clock::now();
+
+    for (int second = 0; second < 100; ++second)
+    {
+        const sample item = { start + std::chrono::seconds(second), second };
+        testee.push_back(item);
+    }
+    CHECK(testee.size() == 20);
+    CHECK(testee.front().value == 80);
+    testee.pop_front();
+    CHECK(testee[0].value == 81);
+}
+
+TEST_CASE("retention_large_ring_buffer unsigned timestamps near zero", "[retention_large_ring_buffer]")
+{
+    cpplargeringbuffer::retention_large_ring_buffer<tick_sample, tick_of, std::uint64_t> testee(4, 8, 10);
+
+    for (int tick = 0; tick < 10; ++tick)
+    {
+        const tick_sample item = { static_cast<std::uint64_t>(tick), tick };
+        testee.push_back(item);
+    }
+    CHECK(testee.size() == 10);
+    CHECK(testee.expire(std::uint64_t(0)) == 0);
+    CHECK(testee.expire(std::uint64_t(9)) == 0);
+    CHECK(testee.size() == 10);
+
+    const tick_sample item = { 12, 12 };
+    testee.push_back(item);
+    CHECK(testee.front().value == 2);
+    CHECK(testee.size() == 9);
+}
@@ -0,0 +1,513 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/segment_spiller.hpp>
+#include <cpplargeringbuffer/huge_page_allocator.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+    std::vector<std::uint32_t> read_spill_file(const char* file_name)
+    {
+        std::vector<std::uint32_t> result;
+        std::ifstream stream(file_name, std::ios::binary);
+        std::uint32_t value = 0;
+        while (stream.read(reinterpret_cast<char*>(&value), sizeof(value)))
+        {
+            result.push_back(value);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("segment_spiller appends evicted segments", "[segment_spiller]")
+{
+    const char* file_name = "test_segment_spiller.bin";
+    std::remove(file_name);
+    const std::uint32_t item_count = 100;
+    {
+        cpplargeringbuffer::large_ring_buffer<std::uint32_t> ringbuffer(4, 4);
+        cpplargeringbuffer::segment_spiller<std::uint32_t> spiller(file_name, 2);
+        spiller.attach(ringbuffer);
+        for (std::uint32_t i = 0; i < item_count; ++i)
+        {
+            ringbuffer.push_back(i);
+        }
+        //a segment is evicted at a time
+        CHECK(ringbuffer.size() > 12);
+        CHECK(ringbuffer.back() == item_count - 1);
+        spiller.flush();
+        CHECK(spiller.get_spilled_count() == ringbuffer.front());
+    }
+
+    const std::vector<std::uint32_t> spilled = read_spill_file(file_name);
+    REQUIRE(spilled.size() >= item_count - 16);
+    for (size_t i = 0; i < spilled.size(); ++i)
+    {
+        CHECK(spilled[i] == i);
+    }
+    std::remove(file_name);
+}
+
+TEST_CASE("segment_spiller recycles handed over segments", "[segment_spiller]")
+{
+    const char* file_name = "test_segment_spiller_recycle.bin";
+    std::remove(file_name);
+    {
+        cpplargeringbuffer::large_ring_buffer<std::uint32_t> ringbuffer(4, 4);
+        cpplargeringbuffer::segment_spiller<std::uint32_t> spiller(file_name);
+        spiller.attach(ringbuffer);
+        for (std::uint32_t i = 0; i < 100; ++i)
+        {
+            ringbuffer.push_back(i);
+            if (i % 4 == 3)
+            {
+                spiller.flush();
+            }
+        }
+        //the first evicted segment is replaced by a new one, the others by written segments
+        CHECK(ringbuffer.get_allocation_statistics().allocated_segments == 5);
+        CHECK(ringbuffer.get_used_segments() == 4);
+        spiller.detach(ringbuffer);
+        CHECK(spiller.get_spilled_count() == 84);
+    }
+
+    const std::vector<std::uint32_t> spilled = read_spill_file(file_name);
+    REQUIRE(spilled.size() == 84);
+    for (size_t i = 0; i < spilled.size(); ++i)
+    {
+        CHECK(spilled[i] == i);
+    }
+    std::remove(file_name);
+}
+
+TEST_CASE("segment_spiller with a stateful allocator", "[segment_spiller]")
+{
+    typedef cpplargeringbuffer::huge_page_allocator<std::uint32_t> allocator_type;
+    const char* file_name = "test_segment_spiller_allocator.bin";
+    std::remove(file_name);
+    std::shared_ptr<cpplargeringbuffer::huge_page_statistics> statistics = std::make_shared<cpplargeringbuffer::huge_page_statistics>();
+    {
+        //a NUMA node maps the segments instead of using the heap, so freeing them with another allocator fails
+        cpplargeringbuffer::large_ring_buffer<std::uint32_t, cpplargeringbuffer::noop_clear_handler<std::uint32_t>, allocator_type> ringbuffer(4, 4, allocator_type(0, statistics));
+        cpplargeringbuffer::segment_spiller<std::uint32_t, allocator_type> spiller(file_name);
+        spiller.attach(ringbuffer);
+        for (std::uint32_t i = 0; i < 100; ++i)
+        {
+            ringbuffer.push_back(i);
+            if (i % 7 == 3)
+            {
+                //unaligned evictions are copied into new buffers
+                ringbuffer.pop_front();
+            }
+            if (i % 4 == 3)
+            {
+                spiller.flush();
+            }
+        }
+        spiller.detach(ringbuffer);
+        CHECK(spiller.get_spilled_count() > 50);
+        for (size_t i = 1; i < ringbuffer.size(); ++i)
+        {
+            REQUIRE(ringbuffer[i] == ringbuffer[i - 1] + 1);
+        }
+    }
+    //every buffer was freed by an allocator sharing the statistics
+    CHECK(statistics->regular_allocations == 0);
+    CHECK(statistics->advised_huge_page_allocations == 0);
+
+    const std::vector<std::uint32_t> spilled = read_spill_file(file_name);
+    CHECK(std::is_sorted(spilled.begin(), spilled.end()));
+    std::remove(file_name);
+}
+
+TEST_CASE("segment_spiller unaligned front", "[segment_spiller]")
+{
+    const char* file_name = "test_segment_spiller_unaligned.bin";
+    std::remove(file_name);
+    {
+        cpplargeringbuffer::large_ring_buffer<std::uint32_t> ringbuffer(3, 4);
+        cpplargeringbuffer::segment_spiller<std::uint32_t> spiller(file_name);
+        spiller.attach(ringbuffer);
+        for (std::uint32_t i = 0; i < 5; ++i)
+        {
+            ringbuffer.push_back(i);
+        }
+        ringbuffer.pop_front();
+        ringbuffer.pop_front();
+        for (std::uint32_t i = 5; i < 40; ++i)
+        {
+            ringbuffer.push_back(i);
+        }
+        spiller.detach(ringbuffer);
+        CHECK(spiller.get_spilled_count() == ringbuffer.front() - 2);
+        CHECK(spiller.get_spilled_count() >= 26);
+        ringbuffer.push_back(40);
+    }
+
+    const std::vector<std::uint32_t> spilled = read_spill_file(file_name);
+    REQUIRE(spilled.size() >= 26);
+    for (size_t i = 0; i < spilled.size(); ++i)
+    {
+        CHECK(spilled[i] == i + 2);
+    }
+    std::remove(file_name);
+}
+
+TEST_CASE("segment_spiller pops while attached", "[segment_spiller]")
+{
+    const char* file_name = "test_segment_spiller_pops.bin";
+    std::remove(file_name);
+    //a ring buffer with the same operations and a plain eviction handler provides the expected file content
+    cpplargeringbuffer::large_ring_buffer<std::uint32_t> reference(4, 4);
+    std::vector<std::uint32_t> reported;
+    reference.set_eviction_handler([&reported](const std::uint32_t* items, size_t count)
+    {
+        reported.insert(reported.end(), items, items + count);
+    });
+    {
+        cpplargeringbuffer::large_ring_buffer<std::uint32_t> ringbuffer(4, 4);
+        cpplargeringbuffer::segment_spiller<std::uint32_t> spiller(file_name);
+        spiller.attach(ringbuffer);
+        auto push = [&](std::uint32_t first, std::uint32_t last)
+        {
+            for (std::uint32_t i = first; i <= last; ++i)
+            {
+                ringbuffer.push_back(i);
+                reference.push_back(i);
+            }
+        };
+        auto pop = [&](size_t count)
+        {
+            for (size_t i = 0; i < count && !ringbuffer.empty(); ++i)
+            {
+                ringbuffer.pop_front();
+                reference.pop_front();
+            }
+        };
+        push(0, 16);
+        pop(16);
+        push(100, 115);
+        pop(3);
+        push(116, 119);
+        spiller.detach(ringbuffer);
+        CHECK(spiller.get_spilled_count() == reported.size());
+    }
+
+    CHECK(read_spill_file(file_name) == reported);
+    std::remove(file_name);
+}
+
+TEST_CASE("segment_spiller random operations while attached", "[segment_spiller]")
+{
+    const char* file_name = "test_segment_spiller_random.bin";
+    std::remove(file_name);
+    cpplargeringbuffer::large_ring_buffer<std::uint32_t> reference(4, 5);
+    std::vector<std::uint32_t> reported;
+    reference.set_eviction_handler([&reported](const std::uint32_t* items, size_t count)
+    {
+        reported.insert(reported.end(), items, items + count);
+    });
+    {
+        cpplargeringbuffer::large_ring_buffer<std::uint32_t> ringbuffer(4, 5);
+        cpplargeringbuffer::segment_spiller<std::uint32_t> spiller(file_name, 2);
+        spiller.attach(ringbuffer);
+        std::mt19937 random(11);
+        std::uint32_t value = 0;
+        for (int operation = 0; operation < 5000; ++operation)
+        {
+            switch (random() % 8)
+            {
+            case 0:
+                if (!ringbuffer.empty())
+                {
+                    ringbuffer.pop_front();
+                    reference.pop_front();
+                }
+                break;
+            case 1:
+                if (!ringbuffer.empty())
+                {
+                    ringbuffer.pop_back();
+                    reference.pop_back();
+                }
+                break;
+            case 2:
+                ringbuffer.push_front(value);
+                reference.push_front(value++);
+                break;
+            case 3:
+            {
+                const size_t count = random() % 7;
+                ringbuffer.release_front(count < ringbuffer.size() ? count : ringbuffer.size());
+                reference.release_front(count < reference.size() ? count : reference.size());
+                break;
+            }
+            default:
+                ringbuffer.push_back(value);
+                reference.push_back(value++);
+                break;
+            }
+        }
+        ringbuffer.resize_segments(3);
+        reference.resize_segments(3);
+        for (int i = 0; i < 40; ++i)
+        {
+            ringbuffer.push_back(value);
+            reference.push_back(value++);
+        }
+        spiller.detach(ringbuffer);
+        CHECK(spiller.get_spilled_count() == reported.size());
+    }
+
+    CHECK(read_spill_file(file_name) == reported);
+    std::remove(file_name);
+}
+
+TEST_CASE("large_ring_buffer eviction handler", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(2, 3);
+    std::vector<size_t> counts;
+    std::vector<int> first_items;
+    testee.set_eviction_handler([&](const int* items, size_t count)
+    {
+        counts.push_back(count);
+        first_items.push_back(*items);
+    });
+
+    for (int i = 0; i < 6; ++i)
+    {
+        testee.push_back(i);
+    }
+    CHECK(counts.empty());
+    for (int i = 6; i < 13; ++i)
+    {
+        testee.push_back(i);
+    }
+    //a segment is evicted at a time
+    REQUIRE(counts.size() == 3);
+    CHECK(counts[0] == 3);
+    CHECK(first_items[0] == 0);
+    CHECK(counts[1] == 3);
+    CHECK(first_items[1] == 3);
+    CHECK(counts[2] == 3);
+    CHECK(first_items[2] == 6);
+    CHECK(testee.front() == 9);
+    CHECK(testee.size() == 4);
+
+    //unaligned front, the rest of the segment is evicted
+    testee.pop_front();
+    testee.push_back(13);
+    testee.push_back(14);
+    testee.push_back(15);
+    CHECK(testee.full());
+    CHECK(counts.size() == 3);
+    testee.push_back(16);
+    REQUIRE(counts.size() == 4);
+    CHECK(counts[3] == 2);
+    CHECK(first_items[3] == 10);
+    CHECK(testee.front() == 12);
+    CHECK(testee.back() == 16);
+
+    //push front does not evict
+    testee.push_front(100);
+    testee.push_front(101);
+    CHECK(counts.size() == 4);
+    CHECK(testee.front() == 101);
+    CHECK(testee.back() == 15);
+}
+
+namespace
+{
+    // checks that the evicted items are the ones at the front of the reference and removes them
+    struct eviction_model
+    {
+        std::deque<int> reference;
+        std::set<int> reported;
+        size_t duplicates = 0;
+
+        void attach(cpplargeringbuffer::large_ring_buffer<int>& testee)
+        {
+            testee.set_eviction_handler([this](const int* items, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    REQUIRE(!reference.empty());
+                    CHECK(reference.front() == items[i]);
+                    duplicates += reported.insert(items[i]).second ? 0 : 1;
+                    reference.pop_front();
+                }
+            });
+        }
+
+        void check(const cpplargeringbuffer::large_ring_buffer<int>& testee) const
+        {
+            REQUIRE(testee.size() == reference.size());
+            for (size_t i = 0; i < reference.size(); ++i)
+            {
+                REQUIRE(testee[i] == reference[i]);
+            }
+        }
+    };
+}
+
+TEST_CASE("large_ring_buffer eviction handler reports each item once", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 5);
+    eviction_model model;
+    model.attach(testee);
+    std::deque<int>& reference = model.reference;
+
+    std::mt19937 random(5);
+    int value = 0;
+    for (int operation = 0; operation < 5000; ++operation)
+    {
+        switch (random() % 9)
+        {
+        case 0:
+            if (!reference.empty())
+            {
+                testee.pop_front();
+                reference.pop_front();
+            }
+            break;
+        case 1:
+            if (!reference.empty())
+            {
+                testee.pop_back();
+                reference.pop_back();
+            }
+            break;
+        case 2:
+            testee.push_front(value);
+            reference.push_front(value++);
+            if (reference.size() > testee.get_max_size())
+            {
+                reference.pop_back();
+            }
+            break;
+        case 3:
+        {
+            std::vector<cpplargeringbuffer::item_span<int> > spans;
+            const size_t reserved = testee.reserve_back(random() % 12, std::back_inserter(spans));
+            for (const cpplargeringbuffer::item_span<int>& span : spans)
+            {
+                for (int& item : span)
+                {
+                    reference.push_back(value);
+                    item = value++;
+                }
+            }
+            testee.commit_back(reserved);
+            break;
+        }
+        case 4:
+        {
+            const size_t count = std::min<size_t>(random() % 12, reference.size());
+            testee.release_front(count);
+            reference.erase(reference.begin(), reference.begin() + static_cast<std::ptrdiff_t>(count));
+            break;
+        }
+        default:
+            testee.push_back(value);
+            reference.push_back(value++);
+            break;
+        }
+        model.check(testee);
+    }
+    CHECK(model.duplicates == 0);
+    CHECK(model.reported.size() > 100);
+}
+
+TEST_CASE("large_ring_buffer eviction handler across resize segments", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 5);
+    std::vector<int> reported;
+    testee.set_eviction_handler([&reported](const int* items, size_t count)
+    {
+        reported.insert(reported.end(), items, items + count);
+    });
+    for (int i = 0; i < 23; ++i)
+    {
+        testee.push_back(i);
+    }
+    //the segment 0..4 is evicted
+    REQUIRE(reported.size() == 5);
+    CHECK(testee.front() == 5);
+
+    testee.resize_segments(6);
+    for (int i = 23; i < 35; ++i)
+    {
+        testee.push_back(i);
+    }
+    CHECK(testee.full());
+    CHECK(reported.size() == 5);
+    testee.push_back(35);
+    REQUIRE(reported.size() == 10);
+    CHECK(reported[5] == 5);
+    CHECK(testee.front() == 10);
+
+    testee.resize_segments(2);
+    CHECK(testee.front() == 26);
+    for (int i = 36; i < 41; ++i)
+    {
+        testee.push_back(i);
+    }
+    CHECK(testee.back() == 40);
+    for (size_t i = 1; i < reported.size(); ++i)
+    {
+        CHECK(reported[i - 1] < reported[i]);
+    }
+}
+
+TEST_CASE("large_ring_buffer eviction handler reports each item once across resize segments", "[large_ring_buffer]")
+{
+    cpplargeringbuffer::large_ring_buffer<int> testee(4, 5);
+    eviction_model model;
+    model.attach(testee);
+    std::deque<int>& reference = model.reference;
+
+    std::mt19937 random(9);
+    int value = 0;
+    for (int operation = 0; operation < 5000; ++operation)
+    {
+        switch (random() % 8)
+        {
+        case 0:
+            if (!reference.empty())
+            {
+                testee.pop_front();
+                reference.pop_front();
+            }
+            break;
+        case 1:
+            testee.push_front(value);
+            reference.push_front(value++);
+            if (reference.size() > testee.get_max_size())
+            {
+                reference.pop_back();
+            }
+            break;
+        case 2:
+            testee.resize_segments(1 + random() % 6);
+            while (reference.size() > testee.get_max_size())
+            {
+                reference.pop_front();
+            }
+            break;
+        default:
+            testee.push_back(value);
+            reference.push_back(value++);
+            break;
+        }
+        model.check(testee);
+    }
+    CHECK(model.duplicates == 0);
+    CHECK(model.reported.size() > 100);
+}
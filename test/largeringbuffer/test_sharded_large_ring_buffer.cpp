@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/sharded_large_ring_buffer.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct log_entry
+    {
+        std::uint64_t sequence;
+        size_t producer;
+    };
+
+    struct sequence_key
+    {
+        std::uint64_t operator()(const log_entry& entry) const
+        {
+            return entry.sequence;
+        }
+    };
+
+    typedef cpplargeringbuffer::sharded_large_ring_buffer<log_entry, sequence_key> sharded_type;
+}
+
+TEST_CASE("sharded_large_ring_buffer ordered view", "[sharded_large_ring_buffer]")
+{
+    sharded_type testee(3, 4, 5);
+    CHECK(testee.get_shard_count() == 3);
+    CHECK(testee.get_max_size() == 60);
+    CHECK(testee.acquire_shard() == 0);
+    CHECK(testee.acquire_shard() == 1);
+    CHECK(testee.acquire_shard() == 2);
+    CHECK(testee.acquire_shard() == 0);
+
+    // every shard has ascending keys, the keys of different shards interleave
+    for (std::uint64_t sequence = 0; sequence < 30; ++sequence)
+    {
+        const size_t shard = (sequence * 7 + sequence / 4) % 3;
+        const log_entry entry = { sequence, shard };
+        testee.push_back(shard, entry);
+    }
+    // same key in two shards, ordered by shard
+    const log_entry duplicate = { 29, 0 };
+    testee.push_back(0, duplicate);
+    CHECK(testee.size() == 31);
+    CHECK(testee.get_used_segments() >= 3);
+
+    {
+        sharded_type::ordered_view view = testee.lock_ordered();
+        std::vector<std::uint64_t> sequences;
+        std::vector<size_t> producers;
+        for (const log_entry& entry : view)
+        {
+            sequences.push_back(entry.sequence);
+            producers.push_back(entry.producer);
+        }
+        REQUIRE(sequences.size() == 31);
+        CHECK(std::is_sorted(sequences.begin(), sequences.end()));
+        CHECK(sequences[29] == 29);
+        CHECK(sequences[30] == 29);
+        CHECK(producers[29] <= producers[30]);
+    }
+
+    {
+        sharded_type::ordered_view view = testee.lock_ordered();
+        sharded_type::ordered_view::iterator it = view.begin();
+        for (int i = 0; i < 10; ++i)
+        {
+            CHECK(it->sequence == static_cast<std::uint64_t>(i));
+            ++it;
+        }
+        view.pop_visited();
+        CHECK(view.begin()->sequence == 10);
+    }
+    CHECK(testee.size() == 21);
+}
+
+TEST_CASE("sharded_large_ring_buffer producer threads", "[sharded_large_ring_buffer]")
+{
+    const size_t producer_count = 4;
+    const std::uint64_t items_per_producer = 5000;
+    sharded_type testee(producer_count, 10, 1000);
+    std::atomic<std::uint64_t> sequence(0);
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producer_count; ++p)
+    {
+        producers.emplace_back([&testee, &sequence, items_per_producer]()
+        {
+            const size_t shard = testee.acquire_shard();
+            for (std::uint64_t i = 0; i < items_per_producer; ++i)
+            {
+                const log_entry entry = { sequence++, shard };
+                testee.push_back(shard, entry);
+            }
+        });
+    }
+
+    size_t merged_total = 0;
+    while (merged_total < producer_count * items_per_producer)
+    {
+        // keys are taken before the push, so order is only guaranteed within a shard; count what is read
+        sharded_type::ordered_view view = testee.lock_ordered();
+        for (const log_entry& entry : view)
+        {
+            (void)entry;
+            ++merged_total;
+        }
+        view.pop_visited();
+    }
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+    CHECK(merged_total == producer_count * items_per_producer);
+    CHECK(testee.size() == 0);
+}
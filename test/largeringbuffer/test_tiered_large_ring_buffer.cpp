@@ -0,0 +1,198 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/cpplargeringbuffer.hpp>
+#include <cpplargeringbuffer/tiered_large_ring_buffer.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_CASE("simple_lz_codec round trip", "[tiered_large_ring_buffer]")
+{
+    std::vector<std::uint32_t> repetitive(1000);
+    for (size_t i = 0; i < repetitive.size(); ++i)
+    {
+        repetitive[i] = static_cast<std::uint32_t>(i % 7);
+    }
+    std::vector<std::uint32_t> random(1000);
+    std::mt19937 generator(42);
+    for (auto& value : random)
+    {
+        value = generator();
+    }
+
+    for (const auto* input : { &repetitive, &random })
+    {
+        std::vector<unsigned char> compressed;
+        cpplargeringbuffer::simple_lz_codec::compress(input->data(), input->size(), compressed);
+        std::vector<std::uint32_t> output(input->size());
+        cpplargeringbuffer::simple_lz_codec::decompress(compressed.data(), compressed.size(), output.data(), output.size());
+        CHECK(output == *input);
+    }
+
+    std::vector<unsigned char> compressed;
+    cpplargeringbuffer::simple_lz_codec::compress(repetitive.data(), repetitive.size(), compressed);
+    CHECK(compressed.size() < repetitive.size() * sizeof(std::uint32_t) / 10);
+
+    std::vector<std::uint32_t> output(repetitive.size());
+    CHECK_THROWS_AS(cpplargeringbuffer::simple_lz_codec::decompress(compressed.data(), compressed.size() / 2, output.data(), output.size()), std::runtime_error);
+}
+
+TEST_CASE("tiered_large_ring_buffer defaults", "[tiered_large_ring_buffer]")
+{
+    const cpplargeringbuffer::tiered_large_ring_buffer<int> testee;
+
+    CHECK(testee.empty());
+    CHECK(!testee.full());
+    CHECK(testee.size() == 0);
+    CHECK(testee.get_max_size() == 0);
+    CHECK(testee.get_segment_size() == 0);
+    CHECK(testee.get_segment_count() == 0);
+    CHECK(testee.get_used_segments() == 0);
+    CHECK(testee.get_memory_usage() == 0);
+}
+
+TEST_CASE("tiered_large_ring_buffer compresses old segments", "[tiered_large_ring_buffer]")
+{
+    cpplargeringbuffer::tiered_large_ring_buffer<std::uint64_t> testee(10, 1000, 2, 1);
+    for (std::uint64_t i = 0; i < testee.get_max_size(); ++i)
+    {
+        testee.push_back(i / 100);
+    }
+    CHECK(testee.full());
+    CHECK(testee.get_used_segments() == 10);
+    CHECK(testee.get_hot_segments() == 2);
+    CHECK(testee.get_memory_usage() < testee.get_max_size() * sizeof(std::uint64_t) / 3);
+
+    for (size_t i = 0; i < testee.size(); ++i)
+    {
+        REQUIRE(testee[i] == i / 100);
+    }
+    CHECK(testee.front() == 0);
+    CHECK(testee.back() == 99);
+    CHECK_THROWS_AS(testee.at(testee.size()), std::range_error);
+
+    //overwriting the oldest segment makes it hot again
+    testee.push_back(100);
+    CHECK(testee.front() == 0);
+    CHECK(testee.back() == 100);
+    CHECK(testee[998] == 9);
+    CHECK(testee.get_hot_segments() == 2);
+
+    testee.clear();
+    CHECK(testee.empty());
+    CHECK(testee.get_used_segments() == 0);
+    CHECK(testee.get_max_size() == 10000);
+}
+
+TEST_CASE("tiered_large_ring_buffer matches large_ring_buffer", "[tiered_large_ring_buffer]")
+{
+    cpplargeringbuffer::tiered_large_ring_buffer<size_t> testee(5, 3, 1, 2);
+    cpplargeringbuffer::large_ring_buffer<size_t> reference(5, 3);
+    std::mt19937 generator(7);
+
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        const size_t operation = generator() % 6;
+        if (operation < 2 && !reference.empty())
+        {
+            testee.pop_front();
+            reference.pop_front();
+        }
+        else if (operation == 2 && !reference.empty())
+        {
+            testee.pop_back();
+            reference.pop_back();
+        }
+        else
+        {
+            testee.push_back(i);
+            reference.push_back(i);
+        }
+        REQUIRE(testee.size() == reference.size());
+        REQUIRE(testee.full() == reference.full());
+        CHECK(testee.get_used_segments() <= reference.get_segment_count());
+        for (size_t j = 0; j < reference.size(); ++j)
+        {
+            REQUIRE(testee[j] == reference[j]);
+        }
+    }
+}
+
+TEST_CASE("frame_of_reference_codec round trip", "[tiered_large_ring_buffer]")
+{
+    std::mt19937_64 generator(3);
+    std::vector<std::uint64_t> timestamps(1000);
+    std::uint64_t timestamp = 1700000000000000000ull;
+    for (auto& value : timestamps)
+    {
+        timestamp += 1000 + generator() % 200;
+        value = timestamp;
+    }
+    std::vector<std::uint64_t> random(130);
+    for (auto& value : random)
+    {
+        value = generator();
+    }
+    std::vector<std::int32_t> decreasing(100);
+    for (size_t i = 0; i < decreasing.size(); ++i)
+    {
+        decreasing[i] = 50 - static_cast<std::int32_t>(i * 3);
+    }
+
+    std::vector<unsigned char> compressed;
+    for (const auto* input : { &timestamps, &random })
+    {
+        cpplargeringbuffer::frame_of_reference_codec::compress(input->data(), input->size(), compressed);
+        std::vector<std::uint64_t> output(input->size());
+        cpplargeringbuffer::frame_of_reference_codec::decompress(compressed.data(), compressed.size(), output.data(), output.size());
+        CHECK(output == *input);
+    }
+
+    cpplargeringbuffer::frame_of_reference_codec::compress(decreasing.data(), decreasing.size(), compressed);
+    std::vector<std::int32_t> output(decreasing.size());
+    cpplargeringbuffer::frame_of_reference_codec::decompress(compressed.data(), compressed.size(), output.data(), output.size());
+    CHECK(output == decreasing);
+
+    //small differences need a few bits per item only
+    cpplargeringbuffer::frame_of_reference_codec::compress(timestamps.data(), timestamps.size(), compressed);
+    CHECK(compressed.size() * 4 < timestamps.size() * sizeof(std::uint64_t));
+
+    std::uint64_t block[cpplargeringbuffer::frame_of_reference_codec::block_size];
+    cpplargeringbuffer::frame_of_reference_codec::decompress_block(compressed.data(), compressed.size(), 3, block, 64);
+    CHECK(block[0] == timestamps[3 * 64]);
+    CHECK(block[63] == timestamps[3 * 64 + 63]);
+    CHECK_THROWS_AS(cpplargeringbuffer::frame_of_reference_codec::decompress_block(compressed.data(), 16, 3, block, 64), std::runtime_error);
+}
+
+TEST_CASE("tiered_large_ring_buffer frame of reference timestamps", "[tiered_large_ring_buffer]")
+{
+    cpplargeringbuffer::tiered_large_ring_buffer<std::uint64_t, cpplargeringbuffer::frame_of_reference_codec> testee(50, 1000, 1);
+    cpplargeringbuffer::large_ring_buffer<std::uint64_t> reference(50, 1000);
+    std::mt19937_64 generator(5);
+    std::uint64_t timestamp = 1700000000000000000ull;
+    for (size_t i = 0; i < 60000; ++i)
+    {
+        timestamp += 500 + generator() % 100;
+        testee.push_back(timestamp);
+        reference.push_back(timestamp);
+    }
+    CHECK(testee.full());
+    CHECK(testee.get_memory_usage() * 4 < testee.get_max_size() * sizeof(std::uint64_t));
+
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        REQUIRE(testee[i] == reference[i]);
+    }
+    //random access decompresses single blocks
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const size_t index = static_cast<size_t>(generator() % reference.size());
+        REQUIRE(testee[index] == reference[index]);
+    }
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        testee.pop_front();
+        reference.pop_front();
+    }
+    CHECK(testee.front() == reference.front());
+    CHECK(testee.back() == reference.back());
+}
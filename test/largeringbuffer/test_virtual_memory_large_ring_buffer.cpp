@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include <cpplargeringbuffer/virtual_memory_large_ring_buffer.hpp>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+TEST_CASE("virtual_memory_large_ring_buffer defaults", "[virtual_memory_large_ring_buffer]")
+{
+    const cpplargeringbuffer::virtual_memory_large_ring_buffer<int> testee;
+
+    CHECK(testee.empty());
+    CHECK(!testee.full());
+    CHECK(testee.size() == 0);
+    CHECK(testee.get_max_size() == 0);
+    CHECK(testee.get_segment_size() == 0);
+    CHECK(testee.get_segment_count() == 0);
+    CHECK(testee.get_used_segments() == 0);
+}
+
+TEST_CASE("virtual_memory_large_ring_buffer contiguous items", "[virtual_memory_large_ring_buffer]")
+{
+    cpplargeringbuffer::virtual_memory_large_ring_buffer<size_t> testee(8, 1000);
+    for (size_t i = 0; i < testee.get_max_size(); ++i)
+    {
+        testee.push_back(i);
+    }
+    CHECK(testee.full());
+    CHECK(testee.get_used_segments() == 8);
+    for (size_t i = 1; i < testee.size(); ++i)
+    {
+        REQUIRE(&testee[i] == &testee[i - 1] + 1);
+        REQUIRE(testee[i] == i);
+    }
+
+    for (size_t i = 0; i < 6500; ++i)
+    {
+        testee.pop_front();
+    }
+    CHECK(testee.get_used_segments() == 4);
+    CHECK(testee.front() == 6500);
+
+    std::stringstream stream;
+    testee.save(stream);
+    cpplargeringbuffer::virtual_memory_large_ring_buffer<size_t> restored;
+    restored.load(stream);
+    REQUIRE(restored.size() == 1500);
+    for (size_t i = 0; i < restored.size(); ++i)
+    {
+        REQUIRE(restored[i] == 6500 + i);
+    }
+
+    testee.clear();
+    CHECK(testee.empty());
+    CHECK(testee.get_used_segments() == 0);
+}
+
+TEST_CASE("virtual_memory_large_ring_buffer matches large_ring_buffer", "[virtual_memory_large_ring_buffer]")
+{
+    //segments smaller than a page share pages with their neighbours
+    cpplargeringbuffer::virtual_memory_large_ring_buffer<std::string, cpplargeringbuffer::clearable_clear_handler<std::string> > testee(7, 3);
+    cpplargeringbuffer::large_ring_buffer<std::string, cpplargeringbuffer::clearable_clear_handler<std::string> > reference(7, 3);
+    std::mt19937 generator(11);
+
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        const std::string value = std::to_string(i) + " a string that does not fit the small string buffer";
+        switch (generator() % 5)
+        {
+        case 0:
+            if (!reference.empty())
+            {
+                testee.pop_front();
+                reference.pop_front();
+            }
+            break;
+        case 1:
+            if (!reference.empty())
+            {
+                testee.pop_back();
+                reference.pop_back();
+            }
+            break;
+        case 2:
+            testee.push_front(value);
+            reference.push_front(value);
+            break;
+        default:
+            testee.push_back(value);
+            reference.push_back(value);
+            break;
+        }
+        REQUIRE(testee.size() == reference.size());
+        REQUIRE(testee.get_used_segments() == reference.get_used_segments());
+        for (size_t j = 0; j < reference.size(); ++j)
+        {
+            REQUIRE(testee[j] == reference[j]);
+        }
+    }
+}
+
+TEST_CASE("virtual_memory_large_ring_buffer rejects sizes that cannot be reserved", "[virtual_memory_large_ring_buffer]")
+{
+    const size_t number_of_segments = std::numeric_limits<size_t>::max() / 4;
+    CHECK_THROWS_AS(cpplargeringbuffer::virtual_memory_large_ring_buffer<size_t>(number_of_segments, 8), std::range_error);
+
+    cpplargeringbuffer::virtual_memory_large_ring_buffer<size_t> testee(2, 8);
+    testee.push_back(1);
+    CHECK_THROWS_AS(testee.discard_and_change_configuration(number_of_segments, 8), std::range_error);
+    CHECK(testee.empty());
+    CHECK(testee.get_max_size() == 0);
+}